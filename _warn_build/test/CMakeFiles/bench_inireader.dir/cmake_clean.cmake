@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_inireader.dir/bench.cpp.o"
+  "CMakeFiles/bench_inireader.dir/bench.cpp.o.d"
+  "bench_inireader"
+  "bench_inireader.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_inireader.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_inireader.dir/test.cpp.o"
+  "CMakeFiles/test_inireader.dir/test.cpp.o.d"
+  "test_inireader"
+  "test_inireader.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_inireader.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_inireader_flat_map.dir/test.cpp.o"
+  "CMakeFiles/test_inireader_flat_map.dir/test.cpp.o.d"
+  "test_inireader_flat_map"
+  "test_inireader_flat_map.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_inireader_flat_map.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_warn_build/test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(inireader "test_inireader")
+set_tests_properties(inireader PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;14;add_test;/root/repo/test/CMakeLists.txt;0;")
+add_test(inireader_flat_map "test_inireader_flat_map")
+set_tests_properties(inireader_flat_map PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;23;add_test;/root/repo/test/CMakeLists.txt;0;")
+subdirs("vendor/googletest")
@@ -0,0 +1,659 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_COMPILED_HPP
+#define INIREADER_COMPILED_HPP
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <iterator>
+#include <random>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "inireader.hpp"
+#include "document.hpp"
+#include "mapped_file.hpp"
+
+namespace ini {
+  namespace utility::compiled {
+    constexpr char magic[4] = {'I', 'N', 'I', 'C'};
+    constexpr std::uint32_t version = 1;
+    /// an image written on a machine with a different byte order reads as a different value
+    constexpr std::uint32_t byte_order = 0x01020304;
+
+    /// Start of every image, all offsets are relative to the start of the image
+    struct Header {
+      char magic[4];
+      std::uint32_t version;
+      std::uint32_t byte_order;
+      /// including the root section, which is always the first one
+      std::uint32_t section_count;
+      std::uint64_t image_size;
+      std::uint64_t source_size;
+      std::int64_t source_mtime;
+      std::uint64_t source_hash;
+      std::uint32_t entry_count;
+      std::uint32_t section_bucket_count;
+      std::uint32_t entry_bucket_count;
+      std::uint32_t reserved;
+      std::uint64_t sections_offset;
+      std::uint64_t entries_offset;
+      std::uint64_t section_buckets_offset;
+      std::uint64_t entry_buckets_offset;
+      std::uint64_t strings_offset;
+      std::uint64_t strings_size;
+    };
+
+    struct SectionRecord {
+      std::uint64_t hash;
+      std::uint32_t name_offset;
+      std::uint32_t name_size;
+      /// the entries of a section are stored next to each other
+      std::uint32_t first;
+      std::uint32_t count;
+    };
+
+    struct EntryRecord {
+      /// HashEntry of the section index and key
+      std::uint64_t hash;
+      std::uint32_t section;
+      std::uint32_t key_offset;
+      std::uint32_t key_size;
+      std::uint32_t value_offset;
+      std::uint32_t value_size;
+      std::uint32_t reserved;
+    };
+
+    /**
+     * @param section index of the section
+     * @param key key of the entry
+     * @return hash of a key within a section, so one table holds the entries of every section
+     */
+    constexpr std::uint64_t HashEntry(const std::uint32_t section, const std::string_view key) {
+      std::uint64_t hash = HashContents(key) ^ ((section + 1ull) * 0x9E3779B97F4A7C15ull);
+      hash ^= hash >> 32;
+      return hash;
+    }
+
+    /**
+     * @param count amount of records
+     * @return amount of buckets, a power of two at most half full so every probe ends at an empty bucket
+     */
+    constexpr std::uint32_t BucketCount(const std::size_t count) {
+      std::uint32_t buckets = 2;
+      while (buckets < count * 2) buckets *= 2;
+      return buckets;
+    }
+
+    /// Pointers into a validated image, cheap to copy so sections stay valid when the document is moved
+    struct Tables {
+      const Header* header = nullptr;
+      const SectionRecord* sections = nullptr;
+      const EntryRecord* entries = nullptr;
+      const std::uint32_t* section_buckets = nullptr;
+      const std::uint32_t* entry_buckets = nullptr;
+      const char* strings = nullptr;
+
+      [[nodiscard]] std::string_view String(const std::uint32_t offset, const std::uint32_t size) const {
+        if (static_cast<std::uint64_t>(offset) + size > header->strings_size) {
+          throw std::runtime_error("Corrupt compiled ini image");
+        }
+        return {strings + offset, size};
+      }
+
+      /**
+       * @tparam Match bool(const Record&)
+       * @return the record or nullptr
+       * @note a table without an empty bucket can only come from a corrupt image, it throws after visiting every bucket instead of probing forever
+       */
+      template <typename Record, typename Match>
+      [[nodiscard]] const Record* Probe(const std::uint32_t* buckets, const std::uint32_t bucket_count, const Record* records, const std::uint32_t count, const std::uint64_t hash, Match&& match) const {
+        const std::uint32_t mask = bucket_count - 1;
+        std::uint32_t i = static_cast<std::uint32_t>(hash) & mask;
+        for (std::uint32_t probes = 0; probes < bucket_count; probes++, i = (i + 1) & mask) {
+          const std::uint32_t index = buckets[i];
+          if (index == 0) return nullptr;
+          if (index > count) throw std::runtime_error("Corrupt compiled ini image");
+
+          const Record& record = records[index - 1];
+          if (record.hash == hash && match(record)) return &record;
+        }
+        throw std::runtime_error("Corrupt compiled ini image");
+      }
+
+      [[nodiscard]] const SectionRecord* FindSection(const std::string_view name) const {
+        return Probe(section_buckets, header->section_bucket_count, sections, header->section_count, HashContents(name), [&](const SectionRecord& record) {
+          // the root section has the empty name but is not a section of its own
+          return &record != sections && String(record.name_offset, record.name_size) == name;
+        });
+      }
+
+      [[nodiscard]] const EntryRecord* FindEntry(const std::uint32_t section, const std::string_view key) const {
+        return Probe(entry_buckets, header->entry_bucket_count, entries, header->entry_count, HashEntry(section, key), [&](const EntryRecord& record) {
+          return record.section == section && String(record.key_offset, record.key_size) == key;
+        });
+      }
+    };
+
+    /// Size, modification time and hash of a source file
+    struct SourceInfo {
+      std::uint64_t size = 0;
+      std::int64_t mtime = 0;
+      std::uint64_t hash = 0;
+    };
+
+    /**
+     * @param file path of the source file
+     * @param info receives size and modification time, hash is left untouched
+     * @return false if the file can't be stat'ed
+     */
+    inline bool Stat(const std::filesystem::path& file, SourceInfo& info) {
+      std::error_code error;
+      const auto size = std::filesystem::file_size(file, error);
+      if (error) return false;
+      const auto mtime = std::filesystem::last_write_time(file, error);
+      if (error) return false;
+
+      info.size = size;
+      info.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+      return true;
+    }
+
+    /**
+     * @param data image to check
+     * @param size size of the image in bytes
+     * @return the tables of the image, header is nullptr when the image is invalid. Records are checked when they are used
+     */
+    inline Tables Validate(const char* data, const std::size_t size) {
+      if (size < sizeof(Header) || reinterpret_cast<std::uintptr_t>(data) % alignof(Header) != 0) return {};
+
+      const auto* header = reinterpret_cast<const Header*>(data);
+      if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version || header->byte_order != byte_order || header->image_size != size) return {};
+
+      const auto fits = [size](const std::uint64_t offset, const std::uint64_t count, const std::size_t element) {
+        return offset % alignof(std::uint64_t) == 0 && offset <= size && count <= (size - offset) / element;
+      };
+      const auto power_of_two = [](const std::uint32_t count, const std::uint32_t records) {
+        return count != 0 && (count & (count - 1)) == 0 && count > records;
+      };
+
+      if (header->section_count == 0 || !fits(header->sections_offset, header->section_count, sizeof(SectionRecord)) || !fits(header->entries_offset, header->entry_count, sizeof(EntryRecord)) ||
+          !power_of_two(header->section_bucket_count, header->section_count) || !fits(header->section_buckets_offset, header->section_bucket_count, sizeof(std::uint32_t)) ||
+          !power_of_two(header->entry_bucket_count, header->entry_count) || !fits(header->entry_buckets_offset, header->entry_bucket_count, sizeof(std::uint32_t)) ||
+          !fits(header->strings_offset, header->strings_size, 1)) {
+        return {};
+      }
+
+      Tables tables;
+      tables.header = header;
+      tables.sections = reinterpret_cast<const SectionRecord*>(data + header->sections_offset);
+      tables.entries = reinterpret_cast<const EntryRecord*>(data + header->entries_offset);
+      tables.section_buckets = reinterpret_cast<const std::uint32_t*>(data + header->section_buckets_offset);
+      tables.entry_buckets = reinterpret_cast<const std::uint32_t*>(data + header->entry_buckets_offset);
+      tables.strings = data + header->strings_offset;
+      return tables;
+    }
+
+    /**
+     * @param parser document to store
+     * @param source size, modification time and hash of the file the document was parsed from
+     * @return the image
+     */
+    inline std::string Build(const Parser& parser, const SourceInfo& source) {
+      std::vector<SectionRecord> sections;
+      std::vector<EntryRecord> entries;
+      std::string strings;
+      sections.reserve(parser.GetSectionCount() + 1);
+
+      const auto add_string = [&strings](const std::string_view str) {
+        if (strings.size() + str.size() >= std::numeric_limits<std::uint32_t>::max()) {
+          throw std::runtime_error("Document too large to compile");
+        }
+        const auto offset = static_cast<std::uint32_t>(strings.size());
+        strings.append(str);
+        return offset;
+      };
+
+      const auto add_section = [&](const std::string_view name, const Parser::IniSection& section) {
+        const auto index = static_cast<std::uint32_t>(sections.size());
+        sections.push_back({HashContents(name), add_string(name), static_cast<std::uint32_t>(name.size()), static_cast<std::uint32_t>(entries.size()), static_cast<std::uint32_t>(section.Size())});
+        char buffer[conversion::utility::format_buffer_size];
+        for (const auto& [key, value] : section) {
+          const auto str = value.Format(buffer);
+          const auto key_offset = add_string(key);
+          entries.push_back({HashEntry(index, key), index, key_offset, static_cast<std::uint32_t>(key.size()), add_string(str), static_cast<std::uint32_t>(str.size()), 0});
+        }
+      };
+
+      add_section({}, parser.GetRootSection());
+      for (auto it = parser.cbegin(); it != parser.cend(); ++it) {
+        add_section(it->first, it->second);
+      }
+
+      if (entries.size() >= std::numeric_limits<std::uint32_t>::max() / 2 || sections.size() >= std::numeric_limits<std::uint32_t>::max() / 2) {
+        throw std::runtime_error("Document too large to compile");
+      }
+
+      const auto fill_buckets = [](const auto& records) {
+        std::vector<std::uint32_t> buckets(BucketCount(records.size()));
+        const std::size_t mask = buckets.size() - 1;
+        for (std::size_t i = 0; i < records.size(); i++) {
+          std::size_t bucket = records[i].hash & mask;
+          while (buckets[bucket] != 0) bucket = (bucket + 1) & mask;
+          buckets[bucket] = static_cast<std::uint32_t>(i + 1);
+        }
+        return buckets;
+      };
+      const auto section_buckets = fill_buckets(sections);
+      const auto entry_buckets = fill_buckets(entries);
+
+      const auto align = [](const std::uint64_t offset) {
+        return (offset + alignof(std::uint64_t) - 1) & ~static_cast<std::uint64_t>(alignof(std::uint64_t) - 1);
+      };
+
+      Header header{};
+      std::memcpy(header.magic, magic, sizeof(magic));
+      header.version = version;
+      header.byte_order = byte_order;
+      header.section_count = static_cast<std::uint32_t>(sections.size());
+      header.entry_count = static_cast<std::uint32_t>(entries.size());
+      header.section_bucket_count = static_cast<std::uint32_t>(section_buckets.size());
+      header.entry_bucket_count = static_cast<std::uint32_t>(entry_buckets.size());
+      header.source_size = source.size;
+      header.source_mtime = source.mtime;
+      header.source_hash = source.hash;
+      header.sections_offset = align(sizeof(Header));
+      header.entries_offset = align(header.sections_offset + sections.size() * sizeof(SectionRecord));
+      header.section_buckets_offset = align(header.entries_offset + entries.size() * sizeof(EntryRecord));
+      header.entry_buckets_offset = align(header.section_buckets_offset + section_buckets.size() * sizeof(std::uint32_t));
+      header.strings_offset = align(header.entry_buckets_offset + entry_buckets.size() * sizeof(std::uint32_t));
+      header.strings_size = strings.size();
+      header.image_size = header.strings_offset + strings.size();
+
+      std::string image(header.image_size, '\0');
+      const auto write = [&image](const std::uint64_t offset, const void* data, const std::size_t size) {
+        if (size != 0) std::memcpy(image.data() + offset, data, size);
+      };
+      write(0, &header, sizeof(header));
+      write(header.sections_offset, sections.data(), sections.size() * sizeof(SectionRecord));
+      write(header.entries_offset, entries.data(), entries.size() * sizeof(EntryRecord));
+      write(header.section_buckets_offset, section_buckets.data(), section_buckets.size() * sizeof(std::uint32_t));
+      write(header.entry_buckets_offset, entry_buckets.data(), entry_buckets.size() * sizeof(std::uint32_t));
+      write(header.strings_offset, strings.data(), strings.size());
+      return image;
+    }
+
+    /**
+     * Writes to a temporary file next to the destination and renames it, processes loading the image never see a partial one
+     * @param image image to write
+     * @param file destination
+     * @return true if the image was written
+     */
+    inline bool SaveImage(const std::string_view image, const std::filesystem::path& file) {
+      auto temp = file;
+      temp += ".tmp" + std::to_string(std::random_device{}());
+
+      {
+        std::ofstream ofs(temp, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+          return false;
+        }
+        ofs.write(image.data(), static_cast<std::streamsize>(image.size()));
+        ofs.close();
+        if (ofs.fail()) {
+          std::error_code error;
+          std::filesystem::remove(temp, error);
+          return false;
+        }
+      }
+
+      std::error_code error;
+      std::filesystem::rename(temp, file, error);
+      if (error) {
+        std::filesystem::remove(temp, error);
+        return false;
+      }
+      return true;
+    }
+  }
+
+  /**
+   * Writes a binary image of the document that CompiledDocument loads without parsing.
+   * @param parser document to store
+   * @param source the file parser was parsed from, its size, modification time and hash are stored to detect when the image is stale
+   * @param image path of the image, usually the source path with the .inic extension
+   * @return true if the image was written
+   */
+  inline bool Compile(const Parser& parser, const std::filesystem::path& source, const std::filesystem::path& image) {
+    utility::compiled::SourceInfo info;
+    if (!utility::compiled::Stat(source, info)) {
+      return false;
+    }
+
+    const MappedFile mapping(source);
+    info.hash = utility::HashContents(mapping.View());
+    return utility::compiled::SaveImage(utility::compiled::Build(parser, info), image);
+  }
+
+  /**
+   * A read only document backed by a binary image made by Compile. Opening an image is a single memory mapping,
+   * sections and entries are found through hash tables stored in the image, nothing is allocated per entry.
+   * @note sections and keys are iterated in an unspecified order
+   */
+  class CompiledDocument {
+  public:
+    using Value = Document::Value;
+    using Entry = std::pair<std::string_view, Value>;
+
+    class Section {
+    public:
+      class Iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Entry;
+
+        Iterator() = default;
+        Iterator(const utility::compiled::Tables* tables, const utility::compiled::EntryRecord* record) : tables_(tables), record_(record) {}
+
+        [[nodiscard]] Entry operator*() const {
+          return {tables_->String(record_->key_offset, record_->key_size), Value(tables_->String(record_->value_offset, record_->value_size))};
+        }
+
+        Iterator& operator++() {
+          ++record_;
+          return *this;
+        }
+
+        Iterator operator++(int) {
+          auto res = *this;
+          ++record_;
+          return res;
+        }
+
+        [[nodiscard]] bool operator==(const Iterator& other) const {
+          return record_ == other.record_;
+        }
+
+        [[nodiscard]] bool operator!=(const Iterator& other) const {
+          return record_ != other.record_;
+        }
+
+      private:
+        const utility::compiled::Tables* tables_ = nullptr;
+        const utility::compiled::EntryRecord* record_ = nullptr;
+      };
+
+      /**
+       * @param key check if the key exists in the section
+       * @return true if the key exists
+       */
+      [[nodiscard]] bool HasValue(const std::string_view key) const {
+        return tables_.FindEntry(index_, key) != nullptr;
+      }
+
+      /**
+       * @return Amount of members in the section
+       */
+      [[nodiscard]] std::size_t Size() const {
+        return tables_.sections[index_].count;
+      }
+
+      /**
+       * @param key key of the value to get
+       * @return the value of the key
+       */
+      [[nodiscard]] Value operator[](const std::string_view key) const {
+        if (const auto* entry = tables_.FindEntry(index_, key)) {
+          return Value(tables_.String(entry->value_offset, entry->value_size));
+        }
+
+        assert(HasValue(key));
+        throw std::runtime_error("Section does not have a value with the key: " + std::string(key));
+      }
+
+      [[nodiscard]] Iterator begin() const noexcept {
+        return {&tables_, tables_.entries + tables_.sections[index_].first};
+      }
+
+      [[nodiscard]] Iterator end() const noexcept {
+        return {&tables_, tables_.entries + tables_.sections[index_].first + tables_.sections[index_].count};
+      }
+
+    private:
+      friend class CompiledDocument;
+      Section(const utility::compiled::Tables& tables, const std::uint32_t index) : tables_(tables), index_(index) {
+        const auto& record = tables_.sections[index_];
+        if (static_cast<std::uint64_t>(record.first) + record.count > tables_.header->entry_count) {
+          throw std::runtime_error("Corrupt compiled ini image");
+        }
+      }
+
+      utility::compiled::Tables tables_;
+      std::uint32_t index_ = 0;
+    };
+
+    using SectionEntry = std::pair<std::string_view, Section>;
+
+    class Iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = SectionEntry;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = SectionEntry;
+
+      Iterator() = default;
+      Iterator(const utility::compiled::Tables* tables, const std::uint32_t index) : tables_(tables), index_(index) {}
+
+      [[nodiscard]] SectionEntry operator*() const {
+        const auto& record = tables_->sections[index_];
+        return {tables_->String(record.name_offset, record.name_size), Section(*tables_, index_)};
+      }
+
+      Iterator& operator++() {
+        ++index_;
+        return *this;
+      }
+
+      Iterator operator++(int) {
+        auto res = *this;
+        ++index_;
+        return res;
+      }
+
+      [[nodiscard]] bool operator==(const Iterator& other) const {
+        return index_ == other.index_;
+      }
+
+      [[nodiscard]] bool operator!=(const Iterator& other) const {
+        return index_ != other.index_;
+      }
+
+    private:
+      const utility::compiled::Tables* tables_ = nullptr;
+      std::uint32_t index_ = 0;
+    };
+
+    /**
+     * @param image path to an image made by Compile, memory mapped for the lifetime of the document
+     */
+    explicit CompiledDocument(const std::filesystem::path& image) : mapping_(image) {
+      Init(mapping_.View());
+    }
+
+    /**
+     * @param image an image made by Compile, the document takes ownership of the buffer
+     */
+    explicit CompiledDocument(std::string&& image) : buffer_(std::make_unique<std::string>(std::move(image))) {
+      Init(*buffer_);
+    }
+
+    CompiledDocument(const CompiledDocument&) = delete;
+    CompiledDocument& operator=(const CompiledDocument&) = delete;
+    CompiledDocument(CompiledDocument&&) noexcept = default;
+    CompiledDocument& operator=(CompiledDocument&&) noexcept = default;
+
+    /**
+     * @param image path to an image made by Compile
+     * @param source the file the image was compiled from
+     * @param verify_contents hash the source even when its size and modification time match
+     * @return the document, or nothing when the image is missing, invalid or older than the source
+     * @note a source with a new modification time but the same size is hashed, so touching the file doesn't make the image stale
+     */
+    static std::optional<CompiledDocument> Open(const std::filesystem::path& image, const std::filesystem::path& source, const bool verify_contents = false) {
+      utility::compiled::SourceInfo info;
+      std::error_code error;
+      if (!utility::compiled::Stat(source, info) || !std::filesystem::is_regular_file(image, error)) {
+        return std::nullopt;
+      }
+
+      MappedFile mapping;
+      try {
+        mapping = MappedFile(image);
+      } catch (const std::exception&) {
+        return std::nullopt;
+      }
+
+      const auto tables = utility::compiled::Validate(mapping.View().data(), mapping.Size());
+      if (!tables.header || tables.header->source_size != info.size) {
+        return std::nullopt;
+      }
+      const auto& header = *tables.header;
+
+      if (verify_contents || header.source_mtime != info.mtime) {
+        try {
+          const MappedFile contents(source);
+          if (utility::HashContents(contents.View()) != header.source_hash) {
+            return std::nullopt;
+          }
+        } catch (const std::exception&) {
+          return std::nullopt;
+        }
+      }
+      return CompiledDocument(std::move(mapping), tables);
+    }
+
+    /**
+     * Opens the image of source, when it is stale the source is parsed instead and the image is rewritten for the next process.
+     * @param source path to a ini file
+     * @param image path of the image, usually the source path with the .inic extension
+     * @param verify_contents hash the source even when its size and modification time match
+     * @return the document
+     * @note failing to write the image is not an error, the document is then backed by memory
+     */
+    static CompiledDocument Load(const std::filesystem::path& source, const std::filesystem::path& image, const bool verify_contents = false) {
+      if (auto document = Open(image, source, verify_contents)) {
+        return std::move(*document);
+      }
+
+      utility::compiled::SourceInfo info;
+      if (!utility::compiled::Stat(source, info)) {
+        assert(std::filesystem::exists(source));
+        throw std::runtime_error("File not found");
+      }
+
+      // stat before reading, a change while parsing then shows up as stale on the next load
+      const MappedFile mapping(source);
+      info.hash = utility::HashContents(mapping.View());
+
+      Parser parser;
+      parser.Parse(std::string(mapping.View()), false);
+      auto compiled = utility::compiled::Build(parser, info);
+      utility::compiled::SaveImage(compiled, image);
+      return CompiledDocument(std::move(compiled));
+    }
+
+    /**
+     * @param section name of the section to check for
+     * @return returns true if the section exists
+     */
+    [[nodiscard]] bool HasSection(const std::string_view section) const {
+      return tables_.FindSection(section) != nullptr;
+    }
+
+    /**
+     * @param section the name of the section
+     * @param key check if the key exists in the section
+     * @return true if the key exists
+     */
+    [[nodiscard]] bool SectionHasValue(const std::string_view section, const std::string_view key) const {
+      const auto* record = tables_.FindSection(section);
+      return record && tables_.FindEntry(static_cast<std::uint32_t>(record - tables_.sections), key);
+    }
+
+    /**
+     * @return count of non root sections
+     */
+    [[nodiscard]] std::size_t GetSectionCount() const {
+      return tables_.header->section_count - 1;
+    }
+
+    /**
+     * @return the root section
+     */
+    [[nodiscard]] Section GetRootSection() const {
+      return {tables_, 0};
+    }
+
+    /**
+     * @param section name of the section to get
+     * @return the section
+     */
+    [[nodiscard]] Section GetSection(const std::string_view section) const {
+      if (const auto* record = tables_.FindSection(section)) {
+        return {tables_, static_cast<std::uint32_t>(record - tables_.sections)};
+      }
+
+      assert(HasSection(section));
+      throw std::runtime_error("Section: " + std::string(section) + " does not exist");
+    }
+
+    /**
+     * @param section name of the section to get
+     * @return the section
+     */
+    [[nodiscard]] Section operator[](const std::string_view section) const {
+      return GetSection(section);
+    }
+
+    [[nodiscard]] Iterator begin() const noexcept {
+      return {&tables_, 1};
+    }
+
+    [[nodiscard]] Iterator end() const noexcept {
+      return {&tables_, tables_.header->section_count};
+    }
+
+  private:
+    MappedFile mapping_;
+    std::unique_ptr<std::string> buffer_;
+    utility::compiled::Tables tables_;
+
+  private:
+    CompiledDocument(MappedFile&& mapping, const utility::compiled::Tables& tables) : mapping_(std::move(mapping)), tables_(tables) {}
+
+    void Init(const std::string_view image) {
+      tables_ = utility::compiled::Validate(image.data(), image.size());
+      if (!tables_.header) {
+        assert(tables_.header);
+        throw std::runtime_error("Not a compiled ini image");
+      }
+    }
+  };
+}
+
+#endif // INIREADER_COMPILED_HPP
@@ -7,7 +7,18 @@
 #ifndef TEST_INIREADER_CONVERSION_HPP
 #define TEST_INIREADER_CONVERSION_HPP
 #include <string>
+#include <string_view>
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
 
 #ifdef min
 #ifdef max
@@ -18,12 +29,12 @@
 
 namespace ini::conversion {
   namespace utility {
-    inline bool IsHex(const std::string& str) {
+    inline bool IsHex(const std::string_view str) {
       if (str.size() < 3) {
         return false;
       }
 
-      if (str[0] != '0' || str[1] != 'x') {
+      if (str[0] != '0' || (str[1] != 'x' && str[1] != 'X')) {
         return false;
       }
 
@@ -36,12 +47,189 @@ namespace ini::conversion {
       return true;
     }
 
-    inline std::int64_t HexToInt64(const std::string& str) {
-      return std::stoll(str, nullptr, 16);
+    /**
+     * @tparam T integer type to parse
+     * @param str decimal number or a number prefixed with 0x, 0o or 0b, optionally signed. The whole string has to be a number
+     * @param out the parsed number, untouched on failure
+     * @return true if str is a number that fits in T
+     */
+    template <typename T>
+    bool ParseInteger(std::string_view str, T& out) {
+      bool negative = false;
+      if (!str.empty() && (str.front() == '-' || str.front() == '+')) {
+        negative = str.front() == '-';
+        str.remove_prefix(1);
+      }
+
+      int base = 10;
+      if (str.size() > 2 && str[0] == '0') {
+        switch (str[1]) {
+          case 'x': case 'X': base = 16; break;
+          case 'o': case 'O': base = 8; break;
+          case 'b': case 'B': base = 2; break;
+          default: break;
+        }
+        if (base != 10) {
+          str.remove_prefix(2);
+        }
+      }
+
+      // the sign is handled above, from_chars would accept a second '-'
+      if (str.empty() || str.front() == '-') {
+        return false;
+      }
+
+      std::uint64_t magnitude{};
+      const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), magnitude, base);
+      if (ec != std::errc() || ptr != str.data() + str.size()) {
+        return false;
+      }
+
+      constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+      if (!negative) {
+        if (magnitude > max) {
+          return false;
+        }
+        out = static_cast<T>(magnitude);
+      } else if constexpr (std::is_signed_v<T>) {
+        if (magnitude > max + 1) {
+          return false;
+        }
+        out = magnitude == max + 1 ? std::numeric_limits<T>::min() : static_cast<T>(-static_cast<T>(magnitude));
+      } else {
+        if (magnitude != 0) {
+          return false;
+        }
+        out = 0;
+      }
+      return true;
     }
 
-    inline std::uint64_t HexToUInt64(const std::string& str) {
-      return std::stoull(str, nullptr, 16);
+    /**
+     * @tparam T floating point type to parse
+     * @param str number in fixed or scientific notation, optionally signed. The whole string has to be a number
+     * @param out the parsed number, untouched on failure
+     * @return true if str is a finite number that fits in T
+     */
+    template <typename T>
+    bool ParseFloat(std::string_view str, T& out) {
+      if (!str.empty() && str.front() == '+') {
+        str.remove_prefix(1);
+      }
+
+      if (str.empty() || str.front() == '+') {
+        return false;
+      }
+
+      T res{};
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+      const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), res);
+      if (ec != std::errc() || ptr != str.data() + str.size()) {
+        return false;
+      }
+#else
+      // no floating point from_chars in this standard library, strtod needs a null terminated copy
+      char buffer[128];
+      if (str.size() >= sizeof(buffer) || std::isspace(static_cast<unsigned char>(str.front()))) {
+        return false;
+      }
+      std::memcpy(buffer, str.data(), str.size());
+      buffer[str.size()] = '\0';
+
+      char* end = nullptr;
+      res = static_cast<T>(std::strtod(buffer, &end));
+      if (end != buffer + str.size()) {
+        return false;
+      }
+#endif
+
+      if (!(res >= -std::numeric_limits<T>::max() && res <= std::numeric_limits<T>::max())) {
+        return false;
+      }
+
+      out = res;
+      return true;
+    }
+
+    /// large enough for FormatNumber of any arithmetic type
+    constexpr std::size_t format_buffer_size = 64;
+
+    /**
+     * @tparam T arithmetic type to format
+     * @param val the number
+     * @param buffer receives the shortest representation that parses back to val, at least format_buffer_size bytes
+     * @return length of the representation
+     */
+    template <typename T>
+    std::size_t FormatNumber(const T val, char* buffer) {
+#if !defined(__cpp_lib_to_chars) || __cpp_lib_to_chars < 201611L
+      if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<std::size_t>(std::snprintf(buffer, format_buffer_size, "%.*g", std::numeric_limits<T>::max_digits10, static_cast<double>(val)));
+      }
+#endif
+      return static_cast<std::size_t>(std::to_chars(buffer, buffer + format_buffer_size, val).ptr - buffer);
+    }
+
+    /**
+     * @tparam T arithmetic type to format
+     * @param val the number
+     * @param out receives the shortest representation that parses back to val
+     */
+    template <typename T>
+    void FormatNumber(const T val, std::string& out) {
+      char buffer[format_buffer_size];
+      out.assign(buffer, FormatNumber(val, buffer));
+    }
+
+    /**
+     * @tparam T std::int64_t or std::uint64_t
+     * @param str base 16 number with an optional sign and 0x prefix, parsing stops at the first character that isn't a hex digit
+     * @return the number
+     * @throws std::invalid_argument if str doesn't start with a hex digit, std::out_of_range if the number doesn't fit in T
+     */
+    template <typename T>
+    T ParseHex(std::string_view str) {
+      bool negative = false;
+      if (!str.empty() && (str.front() == '-' || str.front() == '+')) {
+        negative = str.front() == '-';
+        str.remove_prefix(1);
+      }
+      if (str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X') && std::isxdigit(static_cast<unsigned char>(str[2]))) {
+        str.remove_prefix(2);
+      }
+
+      std::uint64_t magnitude{};
+      const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), magnitude, 16);
+      if (ec == std::errc::invalid_argument) {
+        throw std::invalid_argument("Not a hex number: " + std::string(str));
+      }
+
+      if constexpr (std::is_signed_v<T>) {
+        const auto limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + negative;
+        if (ec == std::errc::result_out_of_range || magnitude > limit) {
+          throw std::out_of_range("Hex number out of range: " + std::string(str));
+        }
+        return negative ? static_cast<T>(0 - magnitude) : static_cast<T>(magnitude);
+      } else {
+        if (ec == std::errc::result_out_of_range || (negative && magnitude != 0)) {
+          throw std::out_of_range("Hex number out of range: " + std::string(str));
+        }
+        return static_cast<T>(magnitude);
+      }
+    }
+
+    inline std::int64_t HexToInt64(const std::string_view str) {
+      return ParseHex<std::int64_t>(str);
+    }
+
+    inline std::uint64_t HexToUInt64(const std::string_view str) {
+      return ParseHex<std::uint64_t>(str);
+    }
+
+    inline bool EqualsIgnoreCase(const std::string_view str, const std::string_view upper) {
+      return str.size() == upper.size() && std::equal(str.begin(), str.end(), upper.begin(), [](const char a, const char b) {
+        return ::toupper(static_cast<unsigned char>(a)) == b;
+      });
     }
 
     // Reference: https://github.com/hermanzdosilovic/petiteutf8
@@ -86,7 +274,7 @@ namespace ini::conversion {
 
     // Reference: https://github.com/hermanzdosilovic/petiteutf8
     template <typename CharType = char16_t>
-    std::basic_string<CharType> DecodeUTF(const std::string& s) {
+    std::basic_string<CharType> DecodeUTF(const std::string_view s) {
       std::size_t capacity{0};
       for (std::size_t i{0}; i < s.length(); ++capacity) {
         auto c{static_cast<CharType>(s[i])};
@@ -137,11 +325,11 @@ namespace ini::conversion {
 
   template <>
   struct AsImpl<std::string> {
-    static bool is(const std::string& val) {
+    static bool is(const std::string_view val) {
       return true;
     }
 
-    static void get(const std::string& val, std::string& out) {
+    static void get(const std::string_view val, std::string& out) {
       out = val;
     }
 
@@ -152,12 +340,12 @@ namespace ini::conversion {
 
   template <>
   struct AsImpl<std::string_view> {
-    static bool is(const std::string& val) {
+    static bool is(const std::string_view val) {
       return true;
     }
 
-    static void get(const std::string& val, std::string_view& out) {
-      out = std::string_view(val.data(), val.size());
+    static void get(const std::string_view val, std::string_view& out) {
+      out = val;
     }
 
     static void set(const std::string_view& val, std::string& out) {
@@ -167,11 +355,11 @@ namespace ini::conversion {
 
   template <>
   struct AsImpl<std::u16string> {
-    static bool is(const std::string& val) {
+    static bool is(const std::string_view val) {
       return true;
     }
 
-    static void get(const std::string& val, std::u16string& out) {
+    static void get(const std::string_view val, std::u16string& out) {
       out = utility::DecodeUTF(val);
     }
 
@@ -182,11 +370,11 @@ namespace ini::conversion {
 
   template <>
   struct AsImpl<std::u32string> {
-    static bool is(const std::string& val) {
+    static bool is(const std::string_view val) {
       return true;
     }
 
-    static void get(const std::string& val, std::u32string& out) {
+    static void get(const std::string_view val, std::u32string& out) {
       out = utility::DecodeUTF<char32_t>(val);
     }
 
@@ -197,26 +385,14 @@ namespace ini::conversion {
 
   template <>
   struct AsImpl<bool> {
-    static bool is(std::string val) {
-      std::transform(val.begin(), val.end(), val.begin(), [](const char c) {
-        return static_cast<char>(::toupper(c));
-      });
-
-      return val == "TRUE" || val == "YES" || val == "ON" || val == "FALSE" || val == "NO" || val == "OFF" || val == "1" || val == "0";
+    static bool is(const std::string_view val) {
+      return IsTrue(val) || IsFalse(val);
     }
 
-    static void get(std::string val, bool& out) {
-      if (!is(val)) {
-        return;
-      }
-
-      std::transform(val.begin(), val.end(), val.begin(), [](const char c) {
-        return static_cast<char>(::toupper(c));
-      });
-
-      if (val == "TRUE" || val == "YES" || val == "ON" || val == "1") {
+    static void get(const std::string_view val, bool& out) {
+      if (IsTrue(val)) {
         out = true;
-      } else if (val == "FALSE" || val == "NO" || val == "OFF" || val == "0") {
+      } else if (IsFalse(val)) {
         out = false;
       }
     }
@@ -224,214 +400,90 @@ namespace ini::conversion {
     static void set(bool val, std::string& out) {
       out = val ? "true" : "false";
     }
-  };
-
-  template <>
-  struct AsImpl<std::int8_t> {
-    static bool is(const std::string& val) {
-      try {
-        const std::int64_t num = utility::IsHex(val) ? utility::HexToInt64(val) : std::stoi(val);
-        return num >= std::numeric_limits<std::int8_t>::min() && num <= std::numeric_limits<std::int8_t>::max();
-      } catch (...) {
-        return false;
-      }
-    }
 
-    static void get(const std::string& val, std::int8_t& out) {
-      out = utility::IsHex(val) ? static_cast<std::int8_t>(utility::HexToInt64(val)) : static_cast<std::int8_t>(std::stoi(val));
+  private:
+    static bool IsTrue(const std::string_view val) {
+      return utility::EqualsIgnoreCase(val, "TRUE") || utility::EqualsIgnoreCase(val, "YES") || utility::EqualsIgnoreCase(val, "ON") || val == "1";
     }
 
-    static void set(std::int8_t val, std::string& out) {
-      out = std::to_string(val);
+    static bool IsFalse(const std::string_view val) {
+      return utility::EqualsIgnoreCase(val, "FALSE") || utility::EqualsIgnoreCase(val, "NO") || utility::EqualsIgnoreCase(val, "OFF") || val == "0";
     }
   };
 
-  template <>
-  struct AsImpl<std::uint8_t> {
-    static bool is(const std::string& val) {
-      try {
-        const std::int64_t num = utility::IsHex(val) ? utility::HexToInt64(val) : std::stoi(val);
-        return num >= 0 && num <= std::numeric_limits<std::uint8_t>::max();
-      } catch (...) {
-        return false;
-      }
+  // Shared implementation of the integer types, parses with ParseInteger
+  template <typename T>
+  struct IntegerAsImpl {
+    static bool is(const std::string_view val) {
+      T tmp{};
+      return utility::ParseInteger(val, tmp);
     }
 
-    static void get(const std::string& val, int& out) {
-      out = utility::IsHex(val) ? static_cast<std::uint8_t>(utility::HexToInt64(val)) : static_cast<std::uint8_t>(std::stoi(val));
+    static void get(const std::string_view val, T& out) {
+      utility::ParseInteger(val, out);
     }
 
-    static void set(std::uint8_t val, std::string& out) {
-      out = std::to_string(val);
+    static void set(const T val, std::string& out) {
+      utility::FormatNumber(val, out);
     }
   };
 
-  template <>
-  struct AsImpl<std::int16_t> {
-    static bool is(const std::string& val) {
-      try {
-        const std::int64_t num = utility::IsHex(val) ? utility::HexToInt64(val) : std::stoi(val);
-        return num >= std::numeric_limits<std::int16_t>::min() && num <= std::numeric_limits<std::int16_t>::max();
-      } catch (...) {
-        return false;
-      }
+  // Shared implementation of the floating point types, parses with ParseFloat
+  template <typename T>
+  struct FloatAsImpl {
+    static bool is(const std::string_view val) {
+      T tmp{};
+      return utility::ParseFloat(val, tmp);
     }
 
-    static void get(const std::string& val, std::int16_t& out) {
-      out = utility::IsHex(val) ? static_cast<std::int16_t>(utility::HexToInt64(val)) : static_cast<std::int16_t>(std::stoi(val));
+    static void get(const std::string_view val, T& out) {
+      utility::ParseFloat(val, out);
     }
 
-    static void set(std::int16_t val, std::string& out) {
-      out = std::to_string(val);
+    static void set(const T val, std::string& out) {
+      utility::FormatNumber(val, out);
     }
   };
 
   template <>
-  struct AsImpl<std::uint16_t> {
-    static bool is(const std::string& val) {
-      try {
-        const std::int64_t num = utility::IsHex(val) ? utility::HexToInt64(val) : std::stoi(val);
-        return num >= std::numeric_limits<std::uint16_t>::min() && num <= std::numeric_limits<std::uint16_t>::max();
-      } catch (...) {
-        return false;
-      }
-    }
-
-    static void get(const std::string& val, std::uint16_t& out) {
-      out = utility::IsHex(val) ? static_cast<std::uint16_t>(utility::HexToInt64(val)) : static_cast<std::uint16_t>(std::stoi(val));
-    }
-
-    static void set(std::uint16_t val, std::string& out) {
-      out = std::to_string(val);
-    }
-  };
+  struct AsImpl<std::int8_t> : IntegerAsImpl<std::int8_t> {};
 
   template <>
-  struct AsImpl<std::int32_t> {
-    static bool is(const std::string& val) {
-      try {
-        const std::int64_t num = utility::IsHex(val) ? utility::HexToInt64(val) : std::stoi(val);
-        return num >= std::numeric_limits<std::int32_t>::min() && num <= std::numeric_limits<std::int32_t>::max();
-      } catch (...) {
-        return false;
-      }
-    }
-
-    static void get(const std::string& val, std::int32_t& out) {
-      out = utility::IsHex(val) ? static_cast<std::int32_t>(utility::HexToInt64(val)) : std::stoi(val);
-    }
-
-    static void set(std::int32_t val, std::string& out) {
-      out = std::to_string(val);
-    }
-  };
+  struct AsImpl<std::uint8_t> : IntegerAsImpl<std::uint8_t> {};
 
   template <>
-  struct AsImpl<std::uint32_t> {
-    static bool is(const std::string& val) {
-      try {
-        const std::int64_t num = utility::IsHex(val) ? utility::HexToInt64(val) : std::stoi(val);
-        return num >= std::numeric_limits<std::uint32_t>::min() && num <= std::numeric_limits<std::uint32_t>::max();
-      } catch (...) {
-        return false;
-      }
-    }
-
-    static void get(const std::string& val, std::uint32_t& out) {
-      out = utility::IsHex(val) ? static_cast<std::uint32_t>(utility::HexToInt64(val)) : static_cast<std::uint32_t>(std::stoi(val));
-    }
-
-    static void set(std::uint32_t val, std::string& out) {
-      out = std::to_string(val);
-    }
-  };
+  struct AsImpl<std::int16_t> : IntegerAsImpl<std::int16_t> {};
 
   template <>
-  struct AsImpl<std::int64_t> {
-    static bool is(const std::string& val) {
-      try {
-        const std::int64_t num = utility::IsHex(val) ? utility::HexToInt64(val) : std::stoi(val);
-        return num >= std::numeric_limits<std::int64_t>::min() && num <= std::numeric_limits<std::int64_t>::max();
-      } catch (...) {
-        return false;
-      }
-    }
-
-    static void get(const std::string& val, std::int64_t& out) {
-      out = utility::IsHex(val) ? utility::HexToInt64(val) : static_cast<std::int64_t>(std::stoi(val));
-    }
-
-    static void set(std::int64_t val, std::string& out) {
-      out = std::to_string(val);
-    }
-  };
+  struct AsImpl<std::uint16_t> : IntegerAsImpl<std::uint16_t> {};
 
   template <>
-  struct AsImpl<std::uint64_t> {
-    static bool is(const std::string& val) {
-      try {
-        const std::uint64_t num = utility::IsHex(val) ? utility::HexToUInt64(val) : std::stoull(val);
-        return num <= std::numeric_limits<std::uint64_t>::max();
-      } catch (...) {
-        return false;
-      }
-    }
-
-    static void get(const std::string& val, std::uint64_t& out) {
-      out = utility::IsHex(val) ? utility::HexToUInt64(val) : std::stoull(val);
-    }
-
-    static void set(std::uint64_t val, std::string& out) {
-      out = std::to_string(val);
-    }
-  };
+  struct AsImpl<std::int32_t> : IntegerAsImpl<std::int32_t> {};
 
   template <>
-  struct AsImpl<float> {
-    static bool is(const std::string& val) {
-      try {
-        return std::stof(val) >= -std::numeric_limits<float>::max() && std::stof(val) <= std::numeric_limits<float>::max();
-      } catch (...) {
-        return false;
-      }
-    }
-
-    static void get(const std::string& val, float& out) {
-      out = std::stof(val);
-    }
+  struct AsImpl<std::uint32_t> : IntegerAsImpl<std::uint32_t> {};
 
-    static void set(float val, std::string& out) {
-      out = std::to_string(val);
-    }
-  };
+  template <>
+  struct AsImpl<std::int64_t> : IntegerAsImpl<std::int64_t> {};
 
   template <>
-  struct AsImpl<double> {
-    static bool is(const std::string& val) {
-      try {
-        return std::stod(val) >= -std::numeric_limits<double>::max() && std::stod(val) <= std::numeric_limits<double>::max();
-      } catch (...) {
-        return false;
-      }
-    }
+  struct AsImpl<std::uint64_t> : IntegerAsImpl<std::uint64_t> {};
 
-    static void get(const std::string& val, double& out) {
-      out = std::stod(val);
-    }
+  template <>
+  struct AsImpl<float> : FloatAsImpl<float> {};
 
-    static void set(double val, std::string& out) {
-      out = std::to_string(val);
-    }
-  };
+  template <>
+  struct AsImpl<double> : FloatAsImpl<double> {};
 
   template <>
   struct AsImpl<const char*> {
-    static bool is(const std::string& val) {
+    static bool is(const std::string_view val) {
       return true;
     }
 
-    static void get(const std::string& val, const char*& out) {
-      out = val.c_str();
+    /// @note val has to be null terminated
+    static void get(const std::string_view val, const char*& out) {
+      out = val.data();
     }
 
     static void set(const char* val, std::string& out) {
@@ -441,12 +493,13 @@ namespace ini::conversion {
 
   template <>
   struct AsImpl<char*> {
-    static bool is(const std::string& val) {
+    static bool is(const std::string_view val) {
       return true;
     }
 
-    static void get(const std::string& val, char* out) {
-      out = const_cast<char*>(val.c_str());
+    /// @note val has to be null terminated
+    static void get(const std::string_view val, char*& out) {
+      out = const_cast<char*>(val.data());
     }
 
     static void set(char* val, std::string& out) {
@@ -0,0 +1,298 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_DOCUMENT_HPP
+#define INIREADER_DOCUMENT_HPP
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "conversion.hpp"
+#include "tokenizer.hpp"
+#include "mapped_file.hpp"
+
+namespace ini {
+  /**
+   * A read only ini document, all keys and values are views into the parsed buffer.
+   * Follows the same rules as Parser: a repeated section replaces the previous one and a repeated key overwrites the previous value.
+   * @note sections and keys are iterated in sorted order
+   */
+  class Document {
+  public:
+    class Value {
+    public:
+      Value() = default;
+      explicit Value(const std::string_view value) : value_(value) {}
+
+      /**
+       * @tparam T return type of the value
+       * @return get value as T
+       */
+      template <typename T>
+      [[nodiscard]] T as() const {
+        static_assert(!std::is_same_v<T, const char*> && !std::is_same_v<T, char*>, "Document values are not null terminated, use std::string_view");
+        conversion::AsImpl<T> as;
+        T res{};
+        if (as.is(value_)) {
+          as.get(value_, res);
+        } else {
+          assert(as.is(value_));
+        }
+        return res;
+      }
+
+      /**
+       * @tparam T type of the value
+       * @return check if value is of type T
+       */
+      template <typename T>
+      [[nodiscard]] bool is() const {
+        conversion::AsImpl<T> as;
+        return as.is(value_);
+      }
+
+    private:
+      std::string_view value_;
+    };
+
+    using Entry = std::pair<std::string_view, Value>;
+
+    class Section {
+    public:
+      /**
+       * @param key check if the key exists in the section
+       * @return true if the key exists
+       */
+      [[nodiscard]] bool HasValue(const std::string_view key) const {
+        return Find(key) != end_;
+      }
+
+      /**
+       * @return Amount of members in the section
+       */
+      [[nodiscard]] std::size_t Size() const {
+        return static_cast<std::size_t>(end_ - begin_);
+      }
+
+      /**
+       * @param key key of the value to get
+       * @return the value of the key
+       */
+      [[nodiscard]] const Value& operator[](const std::string_view key) const {
+        const auto entry = Find(key);
+
+        if (entry != end_) {
+          return entry->second;
+        }
+
+        assert(entry != end_);
+        throw std::runtime_error("Section does not have a value with the key: " + std::string(key));
+      }
+
+      [[nodiscard]] const Entry* begin() const noexcept {
+        return begin_;
+      }
+
+      [[nodiscard]] const Entry* end() const noexcept {
+        return end_;
+      }
+
+    private:
+      friend class Document;
+      const Entry* begin_ = nullptr;
+      const Entry* end_ = nullptr;
+
+      [[nodiscard]] const Entry* Find(const std::string_view key) const {
+        const auto entry = std::lower_bound(begin_, end_, key, [](const Entry& e, const std::string_view k) {
+          return e.first < k;
+        });
+        return entry != end_ && entry->first == key ? entry : end_;
+      }
+    };
+
+    using SectionEntry = std::pair<std::string_view, Section>;
+
+    /**
+     * @param file path to a ini file, the file is memory mapped for the lifetime of the document
+     */
+    explicit Document(const std::filesystem::path& file) : mapping_(file) {
+      Build(mapping_.View());
+    }
+
+    /**
+     * @param contents contents of a ini file, the document takes ownership of the buffer
+     */
+    explicit Document(std::string&& contents) : buffer_(std::make_unique<std::string>(std::move(contents))) {
+      Build(*buffer_);
+    }
+
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+    Document(Document&&) noexcept = default;
+    Document& operator=(Document&&) noexcept = default;
+
+    /**
+     * @param section name of the section to check for
+     * @return returns true if the section exists
+     */
+    [[nodiscard]] bool HasSection(const std::string_view section) const {
+      return Find(section) != sections_.end();
+    }
+
+    /**
+     * @param section the name of the section
+     * @param key check if the key exists in the section
+     * @return true if the key exists
+     */
+    [[nodiscard]] bool SectionHasValue(const std::string_view section, const std::string_view key) const {
+      const auto entry = Find(section);
+      return entry != sections_.end() && entry->second.HasValue(key);
+    }
+
+    /**
+     * @return count of non root sections
+     */
+    [[nodiscard]] std::size_t GetSectionCount() const {
+      return sections_.size();
+    }
+
+    /**
+     * @return the root section
+     */
+    [[nodiscard]] const Section& GetRootSection() const {
+      return root_section_;
+    }
+
+    /**
+     * @param section name of the section to get
+     * @return the section
+     */
+    [[nodiscard]] const Section& GetSection(const std::string_view section) const {
+      const auto entry = Find(section);
+
+      if (entry != sections_.end()) {
+        return entry->second;
+      }
+
+      assert(entry != sections_.end());
+      throw std::runtime_error("Section: " + std::string(section) + " does not exist");
+    }
+
+    /**
+     * @param section name of the section to get
+     * @return the section
+     */
+    [[nodiscard]] const Section& operator[](const std::string_view section) const {
+      return GetSection(section);
+    }
+
+    [[nodiscard]] std::vector<SectionEntry>::const_iterator begin() const noexcept {
+      return sections_.begin();
+    }
+
+    [[nodiscard]] std::vector<SectionEntry>::const_iterator end() const noexcept {
+      return sections_.end();
+    }
+
+  private:
+    MappedFile mapping_;
+    std::unique_ptr<std::string> buffer_;
+    std::vector<Entry> entries_;
+    std::vector<SectionEntry> sections_;
+    Section root_section_;
+
+  private:
+    [[nodiscard]] std::vector<SectionEntry>::const_iterator Find(const std::string_view section) const {
+      const auto entry = std::lower_bound(sections_.begin(), sections_.end(), section, [](const SectionEntry& e, const std::string_view s) {
+        return e.first < s;
+      });
+      return entry != sections_.end() && entry->first == section ? entry : sections_.end();
+    }
+
+    /**
+     * @param contents the buffer to index, has to outlive the document
+     */
+    void Build(const std::string_view contents) {
+      // every occurrence of a section header with the range of entries that follow it, the first one is the root section
+      struct Occurrence {
+        std::string_view name;
+        std::size_t first;
+        std::size_t last;
+      };
+
+      // every item is on its own line, reserving up front avoids holding two copies of the index while growing
+      entries_.reserve(static_cast<std::size_t>(std::count(contents.begin(), contents.end(), '\n')) + 1);
+
+      std::vector<Occurrence> occurrences{{{}, 0, 0}};
+      tokenizer::ScanLines(contents, [&](const std::string_view line, const tokenizer::Delimiters& delimiters) {
+        const auto token = tokenizer::ScanLine(line, delimiters);
+        if (token.type == tokenizer::TokenType::Item) {
+          entries_.emplace_back(token.key, Value(token.value));
+          occurrences.back().last = entries_.size();
+        } else if (token.type == tokenizer::TokenType::Section) {
+          occurrences.push_back({token.key, entries_.size(), entries_.size()});
+        }
+        return true;
+      });
+
+      // a repeated section replaces the previous one, keep the last occurrence of every name
+      std::stable_sort(occurrences.begin() + 1, occurrences.end(), [](const Occurrence& a, const Occurrence& b) {
+        return a.name < b.name;
+      });
+      const auto last_occurrence = std::unique(occurrences.rbegin(), occurrences.rend() - 1, [](const Occurrence& a, const Occurrence& b) {
+        return a.name == b.name;
+      });
+      occurrences.erase(occurrences.begin() + 1, last_occurrence.base());
+
+      // back in file order so the entries can be compacted in place
+      std::sort(occurrences.begin() + 1, occurrences.end(), [](const Occurrence& a, const Occurrence& b) {
+        return a.first < b.first;
+      });
+
+      // sort the keys of every section, a repeated key overwrites the previous value
+      std::size_t write = 0;
+      for (auto& occurrence : occurrences) {
+        const auto first = entries_.begin() + static_cast<std::ptrdiff_t>(occurrence.first);
+        const auto last = entries_.begin() + static_cast<std::ptrdiff_t>(occurrence.last);
+        std::stable_sort(first, last, [](const Entry& a, const Entry& b) {
+          return a.first < b.first;
+        });
+
+        const std::size_t begin = write;
+        for (auto it = first; it != last; ++it) {
+          if (it + 1 != last && (it + 1)->first == it->first) continue;
+          entries_[write++] = *it;
+        }
+        occurrence.first = begin;
+        occurrence.last = write;
+      }
+      entries_.resize(write);
+
+      sections_.reserve(occurrences.size() - 1);
+      for (std::size_t i = 0; i < occurrences.size(); i++) {
+        Section section;
+        section.begin_ = entries_.data() + occurrences[i].first;
+        section.end_ = entries_.data() + occurrences[i].last;
+        if (i == 0) {
+          root_section_ = section;
+        } else {
+          sections_.emplace_back(occurrences[i].name, section);
+        }
+      }
+
+      std::sort(sections_.begin(), sections_.end(), [](const SectionEntry& a, const SectionEntry& b) {
+        return a.first < b.first;
+      });
+    }
+  };
+}
+
+#endif // INIREADER_DOCUMENT_HPP
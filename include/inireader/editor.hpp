@@ -0,0 +1,450 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_EDITOR_HPP
+#define INIREADER_EDITOR_HPP
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+#include "conversion.hpp"
+#include "tokenizer.hpp"
+#include "stream.hpp"
+
+namespace ini {
+  /**
+   * Edits a ini file without reformatting it. Every section and key remembers where it is in the original file,
+   * saving copies the original bytes and only writes the values, keys and sections that changed.
+   * Follows the same rules as Parser: a repeated section replaces the previous one and a repeated key overwrites the previous value.
+   * @note the root section has an empty name
+   * @note a section is indexed the first time it is searched, so even the const functions are not safe to call from multiple threads
+   */
+  class Editor {
+  public:
+    /**
+     * @param file path to a ini file, read into memory so it can be saved over
+     */
+    explicit Editor(const std::filesystem::path& file) {
+      if (!std::filesystem::exists(file)) {
+        assert(!std::filesystem::exists(file));
+        throw std::runtime_error("File not found");
+      }
+
+      if (!std::filesystem::is_regular_file(file)) {
+        assert(!std::filesystem::is_regular_file(file));
+        throw std::runtime_error("Not a regular file");
+      }
+
+      std::ifstream ini_file(file, std::ios::binary);
+      buffer_ = std::make_unique<std::string>(static_cast<std::size_t>(std::filesystem::file_size(file)), '\0');
+      ini_file.read(buffer_->data(), static_cast<std::streamsize>(buffer_->size()));
+      buffer_->resize(static_cast<std::size_t>(ini_file.gcount()));
+      Build();
+    }
+
+    /**
+     * @param contents contents of a ini file
+     */
+    explicit Editor(std::string&& contents) : buffer_(std::make_unique<std::string>(std::move(contents))) {
+      Build();
+    }
+
+    Editor(const Editor&) = delete;
+    Editor& operator=(const Editor&) = delete;
+    Editor(Editor&&) noexcept = default;
+    Editor& operator=(Editor&&) noexcept = default;
+
+    /**
+     * @param section name of the section to check for
+     * @return returns true if the section exists
+     */
+    [[nodiscard]] bool HasSection(const std::string_view section) const {
+      return FindSection(section) != nullptr;
+    }
+
+    /**
+     * @param section the name of the section
+     * @param key check if the key exists in the section
+     * @return true if the key exists
+     */
+    [[nodiscard]] bool HasValue(const std::string_view section, const std::string_view key) const {
+      const auto* entry = FindSection(section);
+      return entry && FindItem(*entry, key) != nullptr;
+    }
+
+    /**
+     * @tparam T return type of the value
+     * @param section the name of the section
+     * @param key key of the value to get
+     * @return get value as T
+     */
+    template <typename T = std::string_view>
+    [[nodiscard]] T Get(const std::string_view section, const std::string_view key) const {
+      static_assert(!std::is_same_v<T, const char*> && !std::is_same_v<T, char*>, "Editor values are not null terminated, use std::string_view");
+      const auto* entry = FindSection(section);
+      if (!entry) {
+        assert(entry);
+        throw std::runtime_error("Section: " + std::string(section) + " does not exist");
+      }
+
+      const auto* item = FindItem(*entry, key);
+      if (!item) {
+        assert(item);
+        throw std::runtime_error("Section does not have a value with the key: " + std::string(key));
+      }
+
+      const auto value = Value(*item);
+      conversion::AsImpl<T> as;
+      T res{};
+      if (as.is(value)) {
+        as.get(value, res);
+      } else {
+        assert(as.is(value));
+      }
+      return res;
+    }
+
+    /**
+     * @tparam T type of value to assign
+     * @param section the name of the section, added at the end of the file if it doesn't exist
+     * @param key key of the value, added after the last key of the section if it doesn't exist
+     * @param value value to assign, written as is so it has to be something the ini format can represent
+     */
+    template <typename T>
+    void Set(const std::string_view section, const std::string_view key, const T& value) {
+      std::string text;
+      if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        text = std::string_view(value);
+      } else {
+        conversion::AsImpl<T> as;
+        as.set(value, text);
+      }
+
+      auto* entry = FindSection(section);
+      if (!entry) {
+        entry = &sections_.emplace_back();
+        entry->name = Own(section);
+        entry->added = true;
+        section_index_[entry->name] = sections_.size() - 1;
+      }
+
+      auto* item = FindItem(*entry, key);
+      if (!item) {
+        item = &entry->items.emplace_back();
+        item->key = Own(key);
+        item->added = true;
+        entry->keys[item->key] = entry->items.size() - 1;
+      }
+
+      if (item->edit == npos) {
+        item->edit = edits_.size();
+        edits_.push_back(std::move(text));
+      } else {
+        edits_[item->edit] = std::move(text);
+      }
+      dirty_ = true;
+    }
+
+    /**
+     * @param section the name of the section
+     * @param key key of the value to remove, every line with this key in the section is removed
+     * @return true if the key existed
+     */
+    bool Remove(const std::string_view section, const std::string_view key) {
+      auto* entry = FindSection(section);
+      if (!entry || !FindItem(*entry, key)) {
+        return false;
+      }
+
+      // earlier lines with the same key would take over when the file is parsed again
+      for (auto& item : entry->items) {
+        if (item.key == key) {
+          item.removed = true;
+        }
+      }
+      entry->keys.erase(entry->keys.find(key));
+      dirty_ = true;
+      return true;
+    }
+
+    /**
+     * @param section name of the section to remove, every occurrence of the section is removed
+     * @return true if the section existed
+     */
+    bool RemoveSection(const std::string_view section) {
+      if (section.empty() || !FindSection(section)) {
+        return false;
+      }
+
+      for (auto& entry : sections_) {
+        if (!entry.root && entry.name == section) {
+          entry.removed = true;
+        }
+      }
+      section_index_.erase(section_index_.find(section));
+      dirty_ = true;
+      return true;
+    }
+
+    /**
+     * @return true if anything changed since the file was read
+     */
+    [[nodiscard]] bool IsDirty() const {
+      return dirty_;
+    }
+
+    /**
+     * @tparam Out std::string or utility::BufferedWriter
+     * @param out receives the original file with the changes applied
+     */
+    template <typename Out, typename = std::enable_if_t<!std::is_base_of_v<std::ostream, Out>>>
+    void Write(Out& out) const {
+      // replaces the bytes in [begin, end) with text, an insert has begin == end
+      struct Change {
+        std::size_t begin;
+        std::size_t end;
+        std::string text;
+        /// text has to start on its own line
+        bool own_line = false;
+      };
+
+      std::vector<Change> changes;
+      std::string eof_text;
+      for (const auto& entry : sections_) {
+        if (entry.removed) {
+          if (!entry.added) changes.push_back({entry.begin, entry.end, {}});
+          continue;
+        }
+
+        std::string inserted;
+        if (entry.added) {
+          inserted.append("[").append(entry.name).append("]").append(newline_);
+        }
+
+        for (const auto& item : entry.items) {
+          if (item.removed) {
+            if (!item.added) changes.push_back({item.line_begin, item.line_end, {}});
+          } else if (item.added) {
+            inserted.append(item.key).append("=").append(edits_[item.edit]).append(newline_);
+          } else if (item.edit != npos) {
+            changes.push_back({item.value_begin, item.value_end, edits_[item.edit]});
+          }
+        }
+
+        if (inserted.empty()) continue;
+        if (entry.added || entry.insert_at == buffer_->size()) {
+          eof_text += inserted;
+        } else {
+          changes.push_back({entry.insert_at, entry.insert_at, std::move(inserted)});
+        }
+      }
+
+      if (!eof_text.empty()) {
+        changes.push_back({buffer_->size(), buffer_->size(), std::move(eof_text), true});
+      }
+
+      std::stable_sort(changes.begin(), changes.end(), [](const Change& a, const Change& b) {
+        return a.begin < b.begin;
+      });
+
+      const std::string_view original = *buffer_;
+      std::size_t copied = 0;
+      char last = '\n';
+      const auto append = [&out, &last](const std::string_view str) {
+        if (!str.empty()) {
+          out.append(str);
+          last = str.back();
+        }
+      };
+
+      for (const auto& change : changes) {
+        append(original.substr(copied, change.begin - copied));
+        // the last line of the file may not have a line break
+        if (change.own_line && last != '\n' && last != '\r') {
+          append(newline_);
+        }
+        append(change.text);
+        copied = change.end;
+      }
+      append(original.substr(copied));
+    }
+
+    /**
+     * @param stream stream to write the ini file to
+     */
+    void Write(std::ostream& stream) const {
+      utility::BufferedWriter writer(stream);
+      Write(writer);
+      writer.Flush();
+    }
+
+    /**
+     * @return the original file with the changes applied
+     */
+    [[nodiscard]] std::string Stringify() const {
+      std::string res;
+      res.reserve(buffer_->size());
+      Write(res);
+      return res;
+    }
+
+    /**
+     * @param out_path the path to the INI file to be saved, can be the file that was read
+     * @return true if succeeded
+     */
+    bool Save(const std::filesystem::path& out_path) const {
+      std::ofstream ofs(out_path, std::ios::binary | std::ios::trunc);
+      if (!ofs.is_open()) {
+        return false;
+      }
+      Write(ofs);
+      ofs.close();
+      return !ofs.fail();
+    }
+
+  private:
+    struct Item {
+      std::string_view key;
+      /// the whole line including the line break
+      std::size_t line_begin = 0;
+      std::size_t line_end = 0;
+      /// the value without quotes and spaces
+      std::size_t value_begin = 0;
+      std::size_t value_end = 0;
+      /// index of the new value in edits_ when the value was changed or added
+      std::size_t edit = npos;
+      bool added = false;
+      bool removed = false;
+    };
+
+    struct Section {
+      std::string_view name;
+      /// from the header up to the next header
+      std::size_t begin = 0;
+      std::size_t end = 0;
+      /// new keys go after the last key, or after the header if there are none
+      std::size_t insert_at = 0;
+      std::vector<Item> items;
+      /// last line of every key, built the first time the section is searched
+      mutable std::unordered_map<std::string_view, std::size_t> keys;
+      mutable bool indexed = false;
+      bool root = false;
+      bool added = false;
+      bool removed = false;
+    };
+
+    /// on the heap so the views into it survive a move
+    std::unique_ptr<std::string> buffer_;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    std::string_view newline_ = "\n";
+    /// every occurrence of every section in file order, the first one is the root section
+    std::deque<Section> sections_;
+    /// last occurrence of every section
+    std::unordered_map<std::string_view, std::size_t> section_index_;
+    /// values that were changed or added
+    std::vector<std::string> edits_;
+    /// names and keys that were added, a deque so the views stay valid
+    std::deque<std::string> owned_;
+    bool dirty_ = false;
+
+  private:
+    [[nodiscard]] std::string_view Own(const std::string_view str) {
+      return owned_.emplace_back(str);
+    }
+
+    [[nodiscard]] std::string_view Value(const Item& item) const {
+      return item.edit != npos ? std::string_view(edits_[item.edit]) : std::string_view(*buffer_).substr(item.value_begin, item.value_end - item.value_begin);
+    }
+
+    [[nodiscard]] const Section* FindSection(const std::string_view section) const {
+      if (section.empty()) {
+        return &sections_.front();
+      }
+
+      const auto entry = section_index_.find(section);
+      return entry != section_index_.end() ? &sections_[entry->second] : nullptr;
+    }
+
+    [[nodiscard]] Section* FindSection(const std::string_view section) {
+      return const_cast<Section*>(std::as_const(*this).FindSection(section));
+    }
+
+    [[nodiscard]] static const Item* FindItem(const Section& section, const std::string_view key) {
+      if (!section.indexed) {
+        section.keys.reserve(section.items.size());
+        for (std::size_t i = 0; i < section.items.size(); i++) {
+          section.keys[section.items[i].key] = i;
+        }
+        section.indexed = true;
+      }
+
+      const auto entry = section.keys.find(key);
+      return entry != section.keys.end() ? &section.items[entry->second] : nullptr;
+    }
+
+    [[nodiscard]] static Item* FindItem(Section& section, const std::string_view key) {
+      return const_cast<Item*>(FindItem(std::as_const(section), key));
+    }
+
+    void Build() {
+      const std::string_view contents = *buffer_;
+      if (contents.find("\r\n") != std::string_view::npos) {
+        newline_ = "\r\n";
+      }
+
+      auto* section = &sections_.emplace_back();
+      section->root = true;
+
+      std::size_t start = 0;
+      while (start < contents.size()) {
+        std::size_t end = start;
+        while (end < contents.size() && contents[end] != '\n' && contents[end] != '\r') end++;
+
+        const auto line = contents.substr(start, end - start);
+        std::size_t next = end < contents.size() ? end + 1 : end;
+        if (end + 1 < contents.size() && contents[end] == '\r' && contents[end + 1] == '\n') {
+          next++;
+        }
+
+        const auto token = tokenizer::ScanLine(line);
+        if (token.type == tokenizer::TokenType::Item) {
+          auto& item = section->items.emplace_back();
+          item.key = token.key;
+          item.line_begin = start;
+          item.line_end = next;
+          item.value_begin = static_cast<std::size_t>(token.value.data() - contents.data());
+          item.value_end = item.value_begin + token.value.size();
+          section->insert_at = next;
+        } else if (token.type == tokenizer::TokenType::Section) {
+          section->end = start;
+          section = &sections_.emplace_back();
+          section->name = token.key;
+          section->begin = start;
+          section->insert_at = next;
+          section_index_[section->name] = sections_.size() - 1;
+        }
+
+        start = next;
+      }
+      section->end = contents.size();
+
+      // without keys new root keys go right before the first section
+      if (sections_.front().items.empty()) {
+        sections_.front().insert_at = sections_.front().end;
+      }
+    }
+  };
+}
+
+#endif // INIREADER_EDITOR_HPP
@@ -0,0 +1,272 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_FLAT_MAP_HPP
+#define INIREADER_FLAT_MAP_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace ini {
+  /**
+   * Open addressing hash map that keeps its entries contiguous in insertion order.
+   * Lookups probe a small table of 32 bit indices and hashes, iteration walks a plain vector.
+   * @note inserting may move existing entries, references and iterators are not stable like they are with std::unordered_map
+   * @note erasing moves the last entry into the erased slot
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>, typename Allocator = std::allocator<std::pair<Key, Value>>>
+  class FlatMap {
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using iterator = typename std::vector<value_type, Allocator>::iterator;
+    using const_iterator = typename std::vector<value_type, Allocator>::const_iterator;
+
+    FlatMap() = default;
+    explicit FlatMap(const allocator_type& alloc) : values_(alloc), buckets_(BucketAllocator(alloc)) {}
+    FlatMap(const FlatMap& other, const allocator_type& alloc) : values_(other.values_, alloc), buckets_(other.buckets_, BucketAllocator(alloc)) {}
+    FlatMap(FlatMap&& other, const allocator_type& alloc) : values_(std::move(other.values_), alloc), buckets_(std::move(other.buckets_), BucketAllocator(alloc)) {}
+    FlatMap(const FlatMap&) = default;
+    FlatMap(FlatMap&&) noexcept = default;
+    FlatMap& operator=(const FlatMap&) = default;
+    FlatMap& operator=(FlatMap&&) = default;
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+      return values_.get_allocator();
+    }
+
+    [[nodiscard]] iterator begin() noexcept {
+      return values_.begin();
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+      return values_.begin();
+    }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept {
+      return values_.cbegin();
+    }
+
+    [[nodiscard]] iterator end() noexcept {
+      return values_.end();
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+      return values_.end();
+    }
+
+    [[nodiscard]] const_iterator cend() const noexcept {
+      return values_.cend();
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+      return values_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+      return values_.empty();
+    }
+
+    void clear() noexcept {
+      values_.clear();
+      buckets_.clear();
+    }
+
+    /**
+     * @tparam K any type Hash and KeyEqual accept
+     * @return iterator to the entry or end()
+     */
+    template <typename K>
+    [[nodiscard]] iterator find(const K& key) {
+      const auto bucket = FindBucket(key);
+      return bucket == npos ? values_.end() : values_.begin() + buckets_[bucket].index - 1;
+    }
+
+    template <typename K>
+    [[nodiscard]] const_iterator find(const K& key) const {
+      const auto bucket = FindBucket(key);
+      return bucket == npos ? values_.end() : values_.begin() + buckets_[bucket].index - 1;
+    }
+
+    /**
+     * Looks up several keys at once, the buckets of every key are prefetched before the first one is probed so the cache misses overlap.
+     * @tparam K any type Hash and KeyEqual accept
+     * @return an iterator to the entry or end() per key
+     */
+    template <typename K, std::size_t N>
+    [[nodiscard]] std::array<const_iterator, N> find_many(const std::array<K, N>& keys) const {
+      std::array<const_iterator, N> res;
+      res.fill(values_.end());
+      if (buckets_.empty()) {
+        return res;
+      }
+
+      const std::size_t mask = buckets_.size() - 1;
+      std::array<std::uint32_t, N> hashes{};
+      for (std::size_t i = 0; i < N; i++) {
+        hashes[i] = static_cast<std::uint32_t>(Hash{}(keys[i]));
+        Prefetch(&buckets_[hashes[i] & mask]);
+      }
+
+      for (std::size_t i = 0; i < N; i++) {
+        if (const auto bucket = FindBucket(keys[i], hashes[i]); bucket != npos) {
+          res[i] = values_.begin() + buckets_[bucket].index - 1;
+        }
+      }
+      return res;
+    }
+
+    /**
+     * @param key key of the entry, only used when it doesn't exist yet
+     * @param args arguments to construct the value with
+     * @return iterator to the entry and true if it was inserted
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+      if (const auto bucket = FindBucket(key); bucket != npos) {
+        return {values_.begin() + buckets_[bucket].index - 1, false};
+      }
+
+      if ((values_.size() + 1) * 2 > buckets_.size()) {
+        Rehash(buckets_.empty() ? 16 : buckets_.size() * 2);
+      }
+
+      const auto hash = static_cast<std::uint32_t>(Hash{}(key));
+      values_.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+      Place({static_cast<std::uint32_t>(values_.size()), hash});
+      return {values_.end() - 1, true};
+    }
+
+    /**
+     * @param pos entry to erase
+     * @return iterator to the entry that took the place of the erased one
+     */
+    iterator erase(const_iterator pos) {
+      const auto index = static_cast<std::uint32_t>(pos - values_.cbegin());
+      EraseBucket(FindBucket(pos->first));
+
+      const auto last = static_cast<std::uint32_t>(values_.size() - 1);
+      if (index != last) {
+        buckets_[FindBucket(values_[last].first)].index = index + 1;
+        values_[index] = std::move(values_[last]);
+      }
+      values_.pop_back();
+      return values_.begin() + index;
+    }
+
+    iterator erase(const iterator pos) {
+      return erase(const_iterator(pos));
+    }
+
+    /**
+     * @return number of erased entries
+     */
+    template <typename K>
+    size_type erase(const K& key) {
+      const auto entry = find(key);
+      if (entry == values_.end()) {
+        return 0;
+      }
+
+      erase(entry);
+      return 1;
+    }
+
+  private:
+    struct Bucket {
+      /// index into values_ plus one, zero marks an empty bucket
+      std::uint32_t index;
+      std::uint32_t hash;
+    };
+
+    using BucketAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Bucket>;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    std::vector<value_type, Allocator> values_;
+    std::vector<Bucket, BucketAllocator> buckets_;
+
+    template <typename K>
+    [[nodiscard]] std::size_t FindBucket(const K& key) const {
+      if (buckets_.empty()) {
+        return npos;
+      }
+
+      return FindBucket(key, static_cast<std::uint32_t>(Hash{}(key)));
+    }
+
+    template <typename K>
+    [[nodiscard]] std::size_t FindBucket(const K& key, const std::uint32_t hash) const {
+      const std::size_t mask = buckets_.size() - 1;
+      for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Bucket& bucket = buckets_[i];
+        if (bucket.index == 0) {
+          return npos;
+        }
+
+        if (bucket.hash == hash && KeyEqual{}(values_[bucket.index - 1].first, key)) {
+          return i;
+        }
+      }
+    }
+
+    static void Prefetch(const void* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+      _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#endif
+    }
+
+    void Place(const Bucket bucket) {
+      const std::size_t mask = buckets_.size() - 1;
+      std::size_t i = bucket.hash & mask;
+      while (buckets_[i].index != 0) {
+        i = (i + 1) & mask;
+      }
+      buckets_[i] = bucket;
+    }
+
+    /// backward shift deletion, keeps every probe sequence free of holes
+    void EraseBucket(std::size_t hole) {
+      const std::size_t mask = buckets_.size() - 1;
+      for (std::size_t next = (hole + 1) & mask; buckets_[next].index != 0; next = (next + 1) & mask) {
+        // an entry can only fill the hole if the hole lies on its probe sequence
+        const std::size_t home = buckets_[next].hash & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+          buckets_[hole] = buckets_[next];
+          hole = next;
+        }
+      }
+      buckets_[hole] = {};
+    }
+
+    void Rehash(const std::size_t capacity) {
+      std::vector<Bucket, BucketAllocator> old(capacity, Bucket{}, buckets_.get_allocator());
+      old.swap(buckets_);
+      for (const auto& bucket : old) {
+        if (bucket.index != 0) {
+          Place(bucket);
+        }
+      }
+    }
+  };
+}
+
+#endif // INIREADER_FLAT_MAP_HPP
@@ -0,0 +1,401 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_FROZEN_HPP
+#define INIREADER_FROZEN_HPP
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "inireader.hpp"
+#include "document.hpp"
+
+namespace ini {
+  namespace utility {
+    /**
+     * A minimal perfect hash over a fixed set of distinct keys, built with hash and displace.
+     * Keys are spread over buckets by their hash, every bucket then gets a seed that sends its keys to free slots.
+     * Buckets of a single key store their slot directly. A lookup is one bucket read and one slot computation.
+     * Keys are hashed with a fixed 64 bit hash, so the result is the same on 32 bit targets, and a salt that is changed when building fails.
+     */
+    class PerfectHash {
+    public:
+      PerfectHash() = default;
+
+      /**
+       * @param keys every key, must be distinct
+       * @return order[slot] is the index in keys of the key that Slot returns slot for
+       */
+      std::vector<std::uint32_t> Build(const std::vector<std::string_view>& keys) {
+        std::vector<std::uint64_t> hashes(keys.size());
+        std::vector<std::uint32_t> order;
+        // a salt whose hashes collide, or leave a bucket without a seed, is replaced by the next one
+        for (salt_ = 0; salt_ < max_salt; salt_++) {
+          for (std::size_t i = 0; i < keys.size(); i++) {
+            hashes[i] = Hash(keys[i], salt_);
+          }
+
+          if (Build(hashes, order)) {
+            return order;
+          }
+        }
+
+        throw std::runtime_error("Failed to build a perfect hash, keys are not distinct");
+      }
+
+      /**
+       * @param key key to look up
+       * @return the slot of the key, for a key that wasn't in the set any slot < Size()
+       */
+      [[nodiscard]] std::uint32_t Slot(const std::string_view key) const noexcept {
+        const auto hash = Hash(key, salt_);
+        const std::int32_t seed = seeds_[Reduce(hash, size_)];
+        return seed < 0 ? static_cast<std::uint32_t>(-(seed + 1)) : Reduce(Mix(hash, static_cast<std::uint32_t>(seed)), size_);
+      }
+
+      /**
+       * @return amount of keys
+       */
+      [[nodiscard]] std::uint32_t Size() const noexcept {
+        return size_;
+      }
+
+    private:
+      static constexpr std::uint32_t max_seed = 1u << 16;
+      static constexpr std::uint32_t max_salt = 64;
+      std::uint32_t size_ = 0;
+      std::uint32_t salt_ = 0;
+      /// negative seeds are -slot - 1 of a bucket with a single key
+      std::vector<std::int32_t> seeds_;
+
+    private:
+      /// @return the hash of key with salt, max_seed is never a seed of a bucket so the bucket and slot hashes don't correlate
+      static constexpr std::uint64_t Hash(const std::string_view key, const std::uint32_t salt) noexcept {
+        return Mix(HashContents(key, salt), max_seed);
+      }
+
+      /**
+       * @param hashes hash of every key
+       * @param order receives order[slot], the index in hashes of the key in that slot
+       * @return false if two hashes are equal or a bucket has no seed below max_seed
+       */
+      bool Build(const std::vector<std::uint64_t>& hashes, std::vector<std::uint32_t>& order) {
+        const auto n = static_cast<std::uint32_t>(hashes.size());
+        size_ = n;
+        seeds_.assign(n, 0);
+        order.assign(n, 0);
+        if (n == 0) return true;
+
+        // keys grouped by bucket with a counting sort, bucket b holds keys[first[b]] up to keys[first[b + 1]]
+        std::vector<std::uint32_t> first(n + 1);
+        for (const auto hash : hashes) first[Reduce(hash, n) + 1]++;
+        for (std::uint32_t b = 0; b < n; b++) first[b + 1] += first[b];
+        std::vector<std::uint32_t> keys(n);
+        {
+          auto fill = first;
+          for (std::uint32_t i = 0; i < n; i++) keys[fill[Reduce(hashes[i], n)]++] = i;
+        }
+        const auto bucket_size = [&first](const std::uint32_t b) {
+          return first[b + 1] - first[b];
+        };
+
+        std::vector<std::uint32_t> by_size(n);
+        for (std::uint32_t b = 0; b < n; b++) by_size[b] = b;
+        std::stable_sort(by_size.begin(), by_size.end(), [&bucket_size](const std::uint32_t a, const std::uint32_t b) {
+          return bucket_size(a) > bucket_size(b);
+        });
+
+        // the largest buckets have the fewest seeds that fit, place them while most slots are free
+        std::vector<bool> taken(n);
+        std::vector<std::uint32_t> slots;
+        std::size_t next = 0;
+        for (; next < by_size.size() && bucket_size(by_size[next]) > 1; next++) {
+          const auto bucket = by_size[next];
+          const auto begin = keys.begin() + first[bucket];
+          const auto end = keys.begin() + first[bucket + 1];
+          // keys with equal hashes get the same slot with every seed
+          for (auto key = begin; key != end; ++key) {
+            for (auto other = key + 1; other != end; ++other) {
+              if (hashes[*key] == hashes[*other]) return false;
+            }
+          }
+
+          for (std::uint32_t seed = 0;; seed++) {
+            if (seed == max_seed) {
+              return false;
+            }
+
+            slots.clear();
+            bool fits = true;
+            for (auto key = begin; key != end; ++key) {
+              const auto slot = Reduce(Mix(hashes[*key], seed), n);
+              if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                fits = false;
+                break;
+              }
+              slots.push_back(slot);
+            }
+
+            if (fits) {
+              seeds_[bucket] = static_cast<std::int32_t>(seed);
+              for (std::size_t i = 0; i < slots.size(); i++) {
+                taken[slots[i]] = true;
+                order[slots[i]] = *(begin + static_cast<std::ptrdiff_t>(i));
+              }
+              break;
+            }
+          }
+        }
+
+        std::uint32_t free_slot = 0;
+        for (; next < by_size.size() && bucket_size(by_size[next]) == 1; next++) {
+          while (taken[free_slot]) free_slot++;
+          taken[free_slot] = true;
+          order[free_slot] = keys[first[by_size[next]]];
+          seeds_[by_size[next]] = -static_cast<std::int32_t>(free_slot) - 1;
+        }
+        return true;
+      }
+
+      /// @return x mapped onto [0, n) by its high bits, cheaper than a modulo
+      static constexpr std::uint32_t Reduce(const std::uint64_t x, const std::uint32_t n) noexcept {
+        return static_cast<std::uint32_t>(((x >> 32) * n) >> 32);
+      }
+
+      /// @return hash rehashed with seed, splitmix64 finalizer
+      static constexpr std::uint64_t Mix(std::uint64_t hash, const std::uint32_t seed) noexcept {
+        hash += (seed + 1ull) * 0x9E3779B97F4A7C15ull;
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+        return hash ^ (hash >> 31);
+      }
+    };
+  }
+
+  /**
+   * An immutable copy of a parsed document. Section names and keys are placed with a minimal perfect hash,
+   * so a lookup is one probe and one key compare. Nothing is mutable, any amount of threads can read it without synchronization.
+   * @note sections and keys are iterated in an unspecified order
+   */
+  class FrozenDocument {
+  public:
+    using Value = Document::Value;
+    using Entry = std::pair<std::string_view, Value>;
+
+    class Section {
+    public:
+      /**
+       * @param key check if the key exists in the section
+       * @return true if the key exists
+       */
+      [[nodiscard]] bool HasValue(const std::string_view key) const {
+        return Find(key) != end_;
+      }
+
+      /**
+       * @return Amount of members in the section
+       */
+      [[nodiscard]] std::size_t Size() const {
+        return static_cast<std::size_t>(end_ - begin_);
+      }
+
+      /**
+       * @param key key of the value to get
+       * @return the value of the key
+       */
+      [[nodiscard]] const Value& operator[](const std::string_view key) const {
+        const auto entry = Find(key);
+
+        if (entry != end_) {
+          return entry->second;
+        }
+
+        assert(entry != end_);
+        throw std::runtime_error("Section does not have a value with the key: " + std::string(key));
+      }
+
+      [[nodiscard]] const Entry* begin() const noexcept {
+        return begin_;
+      }
+
+      [[nodiscard]] const Entry* end() const noexcept {
+        return end_;
+      }
+
+    private:
+      friend class FrozenDocument;
+      const Entry* begin_ = nullptr;
+      const Entry* end_ = nullptr;
+      utility::PerfectHash hash_;
+
+      [[nodiscard]] const Entry* Find(const std::string_view key) const {
+        if (begin_ == end_) return end_;
+        const auto entry = begin_ + hash_.Slot(key);
+        return entry->first == key ? entry : end_;
+      }
+    };
+
+    using SectionEntry = std::pair<std::string_view, Section>;
+
+    /**
+     * @param parser document to copy, later changes to the parser are not seen
+     */
+    explicit FrozenDocument(const Parser& parser) {
+      // one buffer for every name, key and value so the document is a handful of allocations
+      std::size_t strings = 0;
+      std::size_t entries = parser.GetRootSection().Size();
+      // numbers and bools assigned to the parser are formatted into the storage without storing their text in the parser
+      char buffer[conversion::utility::format_buffer_size];
+      const auto measure = [&strings, &buffer](const Parser::IniSection& section) {
+        for (const auto& [key, value] : section) {
+          strings += key.size() + value.Format(buffer).size();
+        }
+      };
+      measure(parser.GetRootSection());
+      for (auto it = parser.cbegin(); it != parser.cend(); ++it) {
+        strings += it->first.size();
+        entries += it->second.Size();
+        measure(it->second);
+      }
+
+      storage_.reserve(strings);
+      entries_.reserve(entries);
+      const auto store = [this](const std::string_view str) {
+        const auto offset = storage_.size();
+        storage_.insert(storage_.end(), str.begin(), str.end());
+        return std::string_view(storage_.data() + offset, str.size());
+      };
+
+      const auto freeze = [&](const Parser::IniSection& section) {
+        const std::size_t first = entries_.size();
+        std::vector<std::string_view> keys;
+        keys.reserve(section.Size());
+        for (const auto& [key, value] : section) {
+          entries_.emplace_back(store(key), Value(store(value.Format(buffer))));
+          keys.push_back(entries_.back().first);
+        }
+
+        Section res;
+        const auto order = res.hash_.Build(keys);
+        std::vector<Entry> placed;
+        placed.reserve(order.size());
+        for (const auto index : order) {
+          placed.push_back(entries_[first + index]);
+        }
+        std::copy(placed.begin(), placed.end(), entries_.begin() + static_cast<std::ptrdiff_t>(first));
+
+        res.begin_ = entries_.data() + first;
+        res.end_ = entries_.data() + entries_.size();
+        return res;
+      };
+
+      root_section_ = freeze(parser.GetRootSection());
+
+      std::vector<SectionEntry> sections;
+      std::vector<std::string_view> names;
+      sections.reserve(parser.GetSectionCount());
+      names.reserve(parser.GetSectionCount());
+      for (auto it = parser.cbegin(); it != parser.cend(); ++it) {
+        sections.emplace_back(store(it->first), freeze(it->second));
+        names.push_back(sections.back().first);
+      }
+
+      const auto order = hash_.Build(names);
+      sections_.reserve(order.size());
+      for (const auto index : order) {
+        sections_.push_back(std::move(sections[index]));
+      }
+    }
+
+    FrozenDocument(const FrozenDocument&) = delete;
+    FrozenDocument& operator=(const FrozenDocument&) = delete;
+    FrozenDocument(FrozenDocument&&) noexcept = default;
+    FrozenDocument& operator=(FrozenDocument&&) noexcept = default;
+
+    /**
+     * @param section name of the section to check for
+     * @return returns true if the section exists
+     */
+    [[nodiscard]] bool HasSection(const std::string_view section) const {
+      return Find(section) != sections_.end();
+    }
+
+    /**
+     * @param section the name of the section
+     * @param key check if the key exists in the section
+     * @return true if the key exists
+     */
+    [[nodiscard]] bool SectionHasValue(const std::string_view section, const std::string_view key) const {
+      const auto entry = Find(section);
+      return entry != sections_.end() && entry->second.HasValue(key);
+    }
+
+    /**
+     * @return count of non root sections
+     */
+    [[nodiscard]] std::size_t GetSectionCount() const {
+      return sections_.size();
+    }
+
+    /**
+     * @return the root section
+     */
+    [[nodiscard]] const Section& GetRootSection() const {
+      return root_section_;
+    }
+
+    /**
+     * @param section name of the section to get
+     * @return the section
+     */
+    [[nodiscard]] const Section& GetSection(const std::string_view section) const {
+      const auto entry = Find(section);
+
+      if (entry != sections_.end()) {
+        return entry->second;
+      }
+
+      assert(entry != sections_.end());
+      throw std::runtime_error("Section: " + std::string(section) + " does not exist");
+    }
+
+    /**
+     * @param section name of the section to get
+     * @return the section
+     */
+    [[nodiscard]] const Section& operator[](const std::string_view section) const {
+      return GetSection(section);
+    }
+
+    [[nodiscard]] std::vector<SectionEntry>::const_iterator begin() const noexcept {
+      return sections_.begin();
+    }
+
+    [[nodiscard]] std::vector<SectionEntry>::const_iterator end() const noexcept {
+      return sections_.end();
+    }
+
+  private:
+    std::vector<char> storage_;
+    std::vector<Entry> entries_;
+    std::vector<SectionEntry> sections_;
+    Section root_section_;
+    utility::PerfectHash hash_;
+
+  private:
+    [[nodiscard]] std::vector<SectionEntry>::const_iterator Find(const std::string_view section) const {
+      if (sections_.empty()) return sections_.end();
+      const auto entry = sections_.begin() + hash_.Slot(section);
+      return entry->first == section ? entry : sections_.end();
+    }
+  };
+}
+
+#endif // INIREADER_FROZEN_HPP
@@ -7,7 +7,6 @@
 #define INIREADER_HPP
 #include <string>
 #include <string_view>
-#include <regex>
 #include <filesystem>
 #include <fstream>
 #include <cassert>
@@ -15,17 +14,473 @@
 #include <utility>
 #include <sstream>
 #include <unordered_map>
+#include <memory_resource>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <array>
+#include <optional>
+#include <vector>
+#include <thread>
+#include <future>
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include "conversion.hpp"
+#include "tokenizer.hpp"
+#include "stream.hpp"
+#include "flat_map.hpp"
+#include "mapped_file.hpp"
+#include "symbol.hpp"
 
 namespace ini {
+  namespace utility {
+    /**
+     * @param data bytes to hash
+     * @param seed changes the hash of every input, 0 is plain FNV-1a
+     * @return 64 bit FNV-1a hash of data, unlike std::hash the same on every platform and run
+     */
+    constexpr std::uint64_t HashContents(const std::string_view data, const std::uint64_t seed = 0) {
+      std::uint64_t hash = 14695981039346656037ull ^ seed;
+      for (const char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+    // map used for sections and items, define INIREADER_FLAT_MAP to use the cache friendly FlatMap
+    // note that FlatMap moves entries when it grows, a IniSection& is only valid until the next AddSection
+#ifdef INIREADER_FLAT_MAP
+    template <typename Value>
+    using SymbolMap = FlatMap<Symbol, Value, SymbolHash, std::equal_to<Symbol>, std::pmr::polymorphic_allocator<std::pair<Symbol, Value>>>;
+#else
+    template <typename Value>
+    using SymbolMap = std::pmr::unordered_map<Symbol, Value, SymbolHash>;
+#endif
+
+    /**
+     * @param map a map keyed by symbols of symbols
+     * @param symbols table the keys of map are from, can be null when map is empty
+     * @param key key to look up, a string that was never interned is not in any map so only the table is searched
+     * @return iterator to the entry or map.end()
+     */
+    template <typename Map>
+    auto FindKey(Map& map, const SymbolTable* symbols, const std::string_view key) {
+      const Symbol symbol = symbols ? symbols->Find(key) : Symbol();
+      return symbol ? map.find(symbol) : map.end();
+    }
+
+    /**
+     * @param map a map keyed by symbols of symbols
+     * @param symbols table the keys of map are from, can be null when map is empty
+     * @param key key to look up, a symbol of another table is looked up by its string
+     * @return iterator to the entry or map.end()
+     */
+    template <typename Map>
+    auto FindKey(Map& map, const SymbolTable* symbols, const Symbol& key) {
+      return key.table() == symbols ? map.find(key) : FindKey(map, symbols, key.View());
+    }
+
+    /**
+     * @param map a map keyed by symbols
+     * @param keys keys to look up, empty symbols are not looked up
+     * @return an iterator to the entry or map.end() per key
+     */
+    template <typename Map, std::size_t N>
+    auto FindKeys(const Map& map, const std::array<Symbol, N>& keys) {
+      std::array<typename Map::const_iterator, N> res;
+      for (std::size_t i = 0; i < N; i++) {
+        res[i] = keys[i] ? map.find(keys[i]) : map.end();
+      }
+      return res;
+    }
+
+    template <typename Value, typename Hash, typename KeyEqual, typename Allocator, std::size_t N>
+    auto FindKeys(const FlatMap<Symbol, Value, Hash, KeyEqual, Allocator>& map, const std::array<Symbol, N>& keys) {
+      return map.find_many(keys);
+    }
+
+    /**
+     * @param map a map keyed by symbols of symbols
+     * @param symbols table the keys of map are from, can be null when map is empty
+     * @param keys keys to look up, resolved to symbols before the map is searched
+     * @return an iterator to the entry or map.end() per key
+     */
+    template <typename Map, std::size_t N>
+    auto FindKeys(const Map& map, const SymbolTable* symbols, const std::array<std::string_view, N>& keys) {
+      std::array<Symbol, N> resolved;
+      if (symbols) {
+        for (std::size_t i = 0; i < N; i++) {
+          resolved[i] = symbols->Find(keys[i]);
+        }
+      }
+      return FindKeys(map, resolved);
+    }
+
+    /**
+     * Holds a value that was assigned as a number or bool, or else remembers the last successful numeric or bool conversion of a value.
+     * Concurrent readers are safe, a store from a reader is skipped when another thread is storing at the same time.
+     */
+    class ValueCache {
+    public:
+      ValueCache() = default;
+
+      ValueCache(const ValueCache& other) noexcept {
+        *this = other;
+      }
+
+      /// the copy of a native value is not formatted, the text of other may still be written by another thread
+      ValueCache& operator=(const ValueCache& other) noexcept {
+        std::uint8_t tag{};
+        std::uint64_t bits{};
+        other.LoadWaiting(tag, bits);
+        ForceStore(static_cast<std::uint8_t>(tag & ~formatted), bits);
+        return *this;
+      }
+
+      /// @return a non zero tag when T can be cached
+      template <typename T>
+      static constexpr std::uint8_t Tag() {
+        return TagImpl<T, Types>(std::make_index_sequence<std::tuple_size_v<Types>>{});
+      }
+
+      /**
+       * @return true if the cache holds a T, which is written to out
+       */
+      template <typename T>
+      bool Get(T& out) const noexcept {
+        std::uint8_t tag{};
+        std::uint64_t bits{};
+        if (!Load(tag, bits) || (tag & type_mask) != Tag<T>()) {
+          return false;
+        }
+
+        std::memcpy(&out, &bits, sizeof(T));
+        return true;
+      }
+
+      /// remembers a conversion, never replaces a native value
+      template <typename T>
+      void Set(const T& value) noexcept {
+        Store(Tag<T>(), ToBits(value));
+      }
+
+      /// holds value as the value itself, its text is formatted when it is first needed
+      template <typename T>
+      void SetNative(const T& value) noexcept {
+        ForceStore(static_cast<std::uint8_t>(Tag<T>() | native), ToBits(value));
+      }
+
+      void Reset() noexcept {
+        ForceStore(0, 0);
+      }
+
+      /// @return true when the value was assigned as a number or bool
+      bool IsNative() const noexcept {
+        std::uint8_t tag{};
+        std::uint64_t bits{};
+        LoadWaiting(tag, bits);
+        return tag & native;
+      }
+
+      /**
+       * @param buffer receives the text of a native value, at least conversion::utility::format_buffer_size bytes
+       * @return length of the text written to buffer, or npos when the value is not native
+       */
+      std::size_t FormatNative(char* buffer) const noexcept {
+        std::uint8_t tag{};
+        std::uint64_t bits{};
+        LoadWaiting(tag, bits);
+        return (tag & native) ? Format(tag, bits, buffer) : npos;
+      }
+
+      /**
+       * Makes the text of a native value readable, format is called once over all threads and the others wait for it.
+       * @param format receives the text of the native value
+       */
+      template <typename F>
+      void FormatOnce(F&& format) {
+        for (;;) {
+          std::uint8_t tag{};
+          std::uint64_t bits{};
+          LoadWaiting(tag, bits);
+          if (!(tag & native) || (tag & formatted)) {
+            return;
+          }
+
+          auto seq = seq_.load(std::memory_order_relaxed);
+          if ((seq & 1) || !seq_.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+            std::this_thread::yield();
+            continue;
+          }
+
+          // like Store, readers that see the tag below have to see the odd sequence as well
+          std::atomic_thread_fence(std::memory_order_release);
+          // another thread may have formatted it between the load and taking the lock
+          tag = tag_.load(std::memory_order_relaxed);
+          bits = bits_.load(std::memory_order_relaxed);
+          if (!(tag & formatted)) {
+            char buffer[conversion::utility::format_buffer_size];
+            try {
+              format(std::string_view(buffer, Format(tag, bits, buffer)));
+            } catch (...) {
+              seq_.store(seq + 2, std::memory_order_release);
+              throw;
+            }
+            tag_.store(static_cast<std::uint8_t>(tag | formatted), std::memory_order_relaxed);
+          }
+          seq_.store(seq + 2, std::memory_order_release);
+          return;
+        }
+      }
+
+    private:
+      using Types = std::tuple<bool, std::int8_t, std::uint8_t, std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, std::int64_t, std::uint64_t, float, double>;
+      static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+      /// the value was assigned as this type, the text of it is not stored until formatted is set
+      static constexpr std::uint8_t native = 0x80;
+      static constexpr std::uint8_t formatted = 0x40;
+      static constexpr std::uint8_t type_mask = 0x3f;
+
+      // seqlock, odd while a store is in progress
+      std::atomic<std::uint32_t> seq_{0};
+      std::atomic<std::uint8_t> tag_{0};
+      std::atomic<std::uint64_t> bits_{0};
+
+      template <typename T, typename List, std::size_t... I>
+      static constexpr std::uint8_t TagImpl(std::index_sequence<I...>) {
+        std::uint8_t tag = 0;
+        ((tag = std::is_same_v<T, std::tuple_element_t<I, List>> ? static_cast<std::uint8_t>(I + 1) : tag), ...);
+        return tag;
+      }
+
+      template <typename T>
+      static std::uint64_t ToBits(const T& value) noexcept {
+        std::uint64_t bits{};
+        std::memcpy(&bits, &value, sizeof(T));
+        return bits;
+      }
+
+      /// @return length of the text of the value tag and bits hold, the same text conversion::AsImpl sets
+      static std::size_t Format(const std::uint8_t tag, const std::uint64_t bits, char* buffer) noexcept {
+        return FormatImpl(static_cast<std::uint8_t>(tag & type_mask), bits, buffer, std::make_index_sequence<std::tuple_size_v<Types>>{});
+      }
+
+      template <std::size_t... I>
+      static std::size_t FormatImpl(const std::uint8_t tag, const std::uint64_t bits, char* buffer, std::index_sequence<I...>) noexcept {
+        std::size_t len = 0;
+        ((tag == I + 1 ? (len = FormatAs<std::tuple_element_t<I, Types>>(bits, buffer), true) : false) || ...);
+        return len;
+      }
+
+      template <typename T>
+      static std::size_t FormatAs(const std::uint64_t bits, char* buffer) noexcept {
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        if constexpr (std::is_same_v<T, bool>) {
+          const std::string_view text = value ? "true" : "false";
+          text.copy(buffer, text.size());
+          return text.size();
+        } else {
+          return conversion::utility::FormatNumber(value, buffer);
+        }
+      }
+
+      bool Load(std::uint8_t& tag, std::uint64_t& bits) const noexcept {
+        const auto seq = seq_.load(std::memory_order_acquire);
+        if (seq & 1) {
+          return false;
+        }
+
+        tag = tag_.load(std::memory_order_relaxed);
+        bits = bits_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return tag != 0 && seq_.load(std::memory_order_relaxed) == seq;
+      }
+
+      /// like Load, waits for a store in progress instead of failing
+      void LoadWaiting(std::uint8_t& tag, std::uint64_t& bits) const noexcept {
+        for (;;) {
+          const auto seq = seq_.load(std::memory_order_acquire);
+          if (!(seq & 1)) {
+            tag = tag_.load(std::memory_order_relaxed);
+            bits = bits_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq) {
+              return;
+            }
+          }
+          std::this_thread::yield();
+        }
+      }
+
+      void Store(const std::uint8_t tag, const std::uint64_t bits) noexcept {
+        auto seq = seq_.load(std::memory_order_relaxed);
+        if ((seq & 1) || !seq_.compare_exchange_strong(seq, seq + 1, std::memory_order_relaxed)) {
+          return;
+        }
+
+        std::atomic_thread_fence(std::memory_order_release);
+        // a native value stays, only its owner replaces it
+        if (!(tag_.load(std::memory_order_relaxed) & native)) {
+          tag_.store(tag, std::memory_order_relaxed);
+          bits_.store(bits, std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+      }
+
+      /// a store by the owner of the value, waits for readers that are storing
+      void ForceStore(const std::uint8_t tag, const std::uint64_t bits) noexcept {
+        auto seq = seq_.load(std::memory_order_relaxed);
+        while ((seq & 1) || !seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_relaxed)) {
+          seq = seq_.load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_release);
+        tag_.store(tag, std::memory_order_relaxed);
+        bits_.store(bits, std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+      }
+    };
+
+    /// Forwards to another memory resource and counts its allocations
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+      explicit CountingResource(std::pmr::memory_resource* upstream) : upstream_(upstream) {}
+
+      /// @return allocations since construction
+      [[nodiscard]] std::size_t Allocations() const noexcept {
+        return allocations_.load(std::memory_order_relaxed);
+      }
+
+    private:
+      std::pmr::memory_resource* upstream_;
+      std::atomic<std::size_t> allocations_{0};
+
+    private:
+      void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        return upstream_->allocate(bytes, alignment);
+      }
+
+      void do_deallocate(void* ptr, const std::size_t bytes, const std::size_t alignment) override {
+        upstream_->deallocate(ptr, bytes, alignment);
+      }
+
+      [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+      }
+    };
+
+    /// ParseStats policy of a normal parse, nothing is measured
+    struct NoStats {};
+
+    /// A std::shared_ptr that can be loaded and stored from multiple threads, uses std::atomic<std::shared_ptr> when available
+    template <typename T>
+    class AtomicSharedPtr {
+    public:
+      AtomicSharedPtr() = default;
+      explicit AtomicSharedPtr(std::shared_ptr<T> ptr) : ptr_(std::move(ptr)) {}
+
+      AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+      AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+      /// not atomic for other, nothing else may use it while it is moved from
+      AtomicSharedPtr(AtomicSharedPtr&& other) noexcept : ptr_(other.Load()) {
+        other.Store(nullptr);
+      }
+
+      /// not atomic for other, nothing else may use it while it is moved from
+      AtomicSharedPtr& operator=(AtomicSharedPtr&& other) noexcept {
+        if (this != &other) {
+          Store(other.Load());
+          other.Store(nullptr);
+        }
+        return *this;
+      }
+
+      [[nodiscard]] std::shared_ptr<T> Load() const noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr >= 201711L
+        return ptr_.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&ptr_, std::memory_order_acquire);
+#endif
+      }
+
+      void Store(std::shared_ptr<T> ptr) noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr >= 201711L
+        ptr_.store(std::move(ptr), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&ptr_, std::move(ptr), std::memory_order_release);
+#endif
+      }
+
+    private:
+#if defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr >= 201711L
+      std::atomic<std::shared_ptr<T>> ptr_;
+#else
+      std::shared_ptr<T> ptr_;
+#endif
+    };
+  }
+
+  /// A key Parser::IniSection::GetMany could not return a value for
+  struct LookupError {
+    enum class Type {
+      /// the section does not have the key
+      Missing,
+      /// the value can't be converted to the requested type
+      Invalid
+    };
+
+    Type type;
+    /// position of the key in the GetMany call
+    std::size_t index;
+    std::string key;
+  };
+
+  /// What a parse did and where its time went, returned by Parser::ParseWithStats
+  struct ParseStats {
+    std::size_t bytes = 0;
+    std::size_t lines = 0;
+    /// section headers, including repeated ones
+    std::size_t sections = 0;
+    /// items, including repeated keys
+    std::size_t keys = 0;
+    /// headers of a section that already existed, the earlier section is replaced
+    std::size_t duplicate_sections = 0;
+    /// items whose key already existed in their section, the earlier value is overwritten
+    std::size_t duplicate_keys = 0;
+    /// whole line and trailing comments
+    std::size_t comments = 0;
+    /// allocations from the memory resource of the parser, zero when a parser that doesn't wipe on parse adds to a document no measured parse started
+    std::size_t allocations = 0;
+    /// reading the file or stream, zero for contents passed as a string
+    std::chrono::nanoseconds read{0};
+    /// splitting lines and finding sections, items and comments
+    std::chrono::nanoseconds tokenize{0};
+    /// adding sections and items to the document
+    std::chrono::nanoseconds insert{0};
+  };
+
   class Parser {
   public:
+    /// receives the statistics of every parse once it is done
+    using ParseHook = std::function<void(const ParseStats&)>;
+
     /**
      * @param wipe_on_parse wipe the ini file root_ when parsing a new document
+     * @param resource memory resource all sections, keys and values are allocated from, has to outlive the parser
+     * @note with a std::pmr::monotonic_buffer_resource freeing a document is a no-op, memory of wiped documents is only reclaimed when the resource is released
      */
-    explicit Parser(const bool wipe_on_parse = true) {
+    explicit Parser(const bool wipe_on_parse = true, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
       wipe_on_parse_ = wipe_on_parse;
-      root_ = std::make_unique<IniRoot>();
+      resource_ = resource;
+      symbols_ = std::make_shared<utility::SymbolTable>(resource);
+      root_ = std::make_unique<IniRoot>(resource_, symbols_);
+      published_.Store(std::make_shared<const IniRoot>(resource_, symbols_));
     }
 
     /**
@@ -33,21 +488,54 @@ namespace ini {
      * @param is_path is the file a path or contents of a ini file
      */
     void Parse(const std::string& file, const bool is_path) {
+      if (parse_hook_) {
+        ParseWithStats(file, is_path);
+        return;
+      }
+
       if (is_path) {
         CheckValidFile(file);
 
         std::ifstream ini_file(file);
         Parse(ini_file);
       } else {
-        auto lines = Split(file);
-        ImplParse(lines);
+        auto builder = BeginParse();
+        ParseBuffer(file, builder);
+      }
+    }
+
+    /**
+     * Takes ownership of the contents, values point into them instead of being copied.
+     * @param file path/contents of ini file
+     * @param is_path is the file a path or contents of a ini file
+     * @note the contents are freed once no value of them is left, a '\0' is written after every value
+     */
+    void Parse(std::string&& file, const bool is_path) {
+      if (is_path) {
+        Parse(static_cast<const std::string&>(file), true);
+        return;
+      }
+
+      auto buffer = std::make_shared<std::string>(std::move(file));
+      if (parse_hook_) {
+        ParseContents(*buffer, {}, buffer);
+        return;
       }
+
+      auto builder = BeginParse();
+      builder.buffer = buffer;
+      ParseBuffer(*buffer, builder);
     }
 
     /**
      * @param file path to a ini file
      */
     void Parse(const std::filesystem::path& file) {
+      if (parse_hook_) {
+        ParseWithStats(file);
+        return;
+      }
+
       CheckValidFile(file);
 
       std::ifstream ini_file(file);
@@ -58,88 +546,361 @@ namespace ini {
      * @param file a open stream of a ini file
      */
     void Parse(std::fstream& file) {
-      auto lines = ReadFile(file);
-      ImplParse(lines);
+      if (parse_hook_) {
+        ParseWithStats(file);
+        return;
+      }
+
+      auto builder = BeginParse();
+      ParseStream(file, builder);
     }
 
     /**
      * @param file a open stream of a ini file
      */
     void Parse(std::ifstream& file) {
-      auto lines = ReadFile(file);
-      ImplParse(lines);
+      if (parse_hook_) {
+        ParseWithStats(file);
+        return;
+      }
+
+      auto builder = BeginParse();
+      ParseStream(file, builder);
+    }
+
+    /**
+     * Same as Parse, also counts what was parsed and times reading, tokenizing and inserting.
+     * A file is read completely before it is parsed so reading can be timed on its own.
+     * @param file path/contents of ini file
+     * @param is_path is the file a path or contents of a ini file
+     * @return statistics of this parse
+     * @note timing every section and item makes this parse slower, Parse measures nothing unless a ParseHook is set.
+     * The document it starts counts allocations until the next wipe, so later edits of it pay for the counting as well
+     */
+    ParseStats ParseWithStats(const std::string& file, const bool is_path) {
+      if (is_path) {
+        return ParseWithStats(std::filesystem::path(file));
+      }
+      return ParseContents(file, {});
+    }
+
+    /**
+     * Same as Parse, also counts what was parsed and times reading, tokenizing and inserting.
+     * @param file path/contents of ini file, contents are owned by the document like with Parse
+     * @param is_path is the file a path or contents of a ini file
+     * @return statistics of this parse
+     */
+    ParseStats ParseWithStats(std::string&& file, const bool is_path) {
+      if (is_path) {
+        return ParseWithStats(std::filesystem::path(file));
+      }
+
+      auto buffer = std::make_shared<std::string>(std::move(file));
+      return ParseContents(*buffer, {}, buffer);
+    }
+
+    /**
+     * Same as Parse, also counts what was parsed and times reading, tokenizing and inserting.
+     * @param file path to a ini file
+     * @return statistics of this parse
+     */
+    ParseStats ParseWithStats(const std::filesystem::path& file) {
+      CheckValidFile(file);
+
+      std::ifstream ini_file(file);
+      return ParseWithStats(ini_file);
+    }
+
+    /**
+     * Same as Parse, also counts what was parsed and times reading, tokenizing and inserting.
+     * @param file a open stream of a ini file
+     * @return statistics of this parse
+     */
+    ParseStats ParseWithStats(std::istream& file) {
+      const auto start = std::chrono::steady_clock::now();
+      std::string contents;
+      char chunk[64 * 1024];
+      while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0) {
+        contents.append(chunk, static_cast<std::size_t>(file.gcount()));
+      }
+      return ParseContents(contents, std::chrono::steady_clock::now() - start);
+    }
+
+    /**
+     * @param hook called with the statistics of every parse, Parse then measures like ParseWithStats. An empty hook turns it off
+     * @note ParseParallel is not measured
+     */
+    void SetParseHook(ParseHook hook) {
+      parse_hook_ = std::move(hook);
+    }
+
+    /**
+     * Splits the document at section headers and parses the parts on multiple threads, the result is the same as Parse.
+     * @param file path/contents of ini file
+     * @param is_path is the file a path or contents of a ini file
+     * @param threads amount of threads to use, 0 uses std::thread::hardware_concurrency()
+     * @note the memory resource of the parser has to be thread safe, the default resource is
+     */
+    void ParseParallel(const std::string& file, const bool is_path, const unsigned threads = 0) {
+      if (is_path) {
+        ParseParallel(std::filesystem::path(file), threads);
+      } else {
+        ParseChunks(file, threads);
+      }
+    }
+
+    /**
+     * Splits the document at section headers and parses the parts on multiple threads, the result is the same as Parse.
+     * @param file path to a ini file, the file is memory mapped while parsing
+     * @param threads amount of threads to use, 0 uses std::thread::hardware_concurrency()
+     * @note the memory resource of the parser has to be thread safe, the default resource is
+     */
+    void ParseParallel(const std::filesystem::path& file, const unsigned threads = 0) {
+      CheckValidFile(file);
+
+      const MappedFile mapping(file);
+      ParseChunks(mapping.View(), threads);
     }
 
     struct IniValue {
     public:
+      using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+      IniValue() = default;
+      explicit IniValue(const allocator_type& alloc) : value_(alloc) {}
+      IniValue(const IniValue& other, const allocator_type& alloc) : value_(other.StoredText(), alloc), shared_(other.shared_), shared_size_(other.shared_size_), cache_(other.cache_) {}
+      IniValue(IniValue&& other, const allocator_type& alloc) : value_(std::move(other.value_), alloc), shared_(std::move(other.shared_)), shared_size_(other.shared_size_), cache_(other.cache_) {}
+      IniValue(const IniValue& other) : value_(other.StoredText()), shared_(other.shared_), shared_size_(other.shared_size_), cache_(other.cache_) {}
+      IniValue(IniValue&&) noexcept = default;
+      IniValue& operator=(IniValue&&) = default;
+
+      IniValue& operator=(const IniValue& other) {
+        if (this != &other) {
+          value_.assign(other.StoredText());
+          shared_ = other.shared_;
+          shared_size_ = other.shared_size_;
+          cache_ = other.cache_;
+        }
+        return *this;
+      }
+
       /**
        * @tparam T return type of the value
        * @return get value as T
        */
       template <typename T>
       [[nodiscard]] T as() const {
-        conversion::AsImpl<T> as;
         T res;
-        if (as.is(value_)) {
-          as.get(value_, res);
-        } else {
-          assert(as.is(value_));
+        if (!TryAs(res)) {
+          assert(is<T>());
         }
         return res;
       }
 
+      /**
+       * @tparam T type of the value
+       * @param out receives the value, untouched when it is not a T
+       * @return true if the value is a T
+       */
+      template <typename T>
+      bool TryAs(T& out) const {
+        // a value assigned as a T is returned without parsing
+        if constexpr (utility::ValueCache::Tag<T>() != 0) {
+          if (cache_.Get(out)) {
+            return true;
+          }
+        }
+
+        const std::string_view text = Text();
+        conversion::AsImpl<T> as;
+        if (!as.is(text)) {
+          return false;
+        }
+
+        as.get(text, out);
+        if constexpr (utility::ValueCache::Tag<T>() != 0) {
+          cache_.Set(out);
+        }
+        return true;
+      }
+
       /**
        * @tparam T type of the value
        * @return check if value is of type T
        */
       template <typename T>
       [[nodiscard]] bool is() const {
+        if constexpr (utility::ValueCache::Tag<T>() != 0) {
+          T res;
+          if (cache_.Get(res)) {
+            return true;
+          }
+        }
+
         conversion::AsImpl<T> as;
-        return as.is(value_);
+        return as.is(Text());
       }
 
       /**
+       * Numbers and bools are stored as they are and only turned into text when the text is asked for, by Stringify or Save for example.
        * @tparam T type of value to assign
        */
       template <typename T>
       IniValue& operator=(const T& value) {
-        conversion::AsImpl<T> as;
-        as.set(value, value_);
+        shared_.reset();
+        if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+          cache_.Reset();
+          value_.assign(std::string_view(value));
+        } else if constexpr (utility::ValueCache::Tag<T>() != 0) {
+          value_.clear();
+          cache_.SetNative(value);
+        } else {
+          cache_.Reset();
+          conversion::AsImpl<T> as;
+          std::string tmp;
+          as.set(value, tmp);
+          value_.assign(tmp);
+        }
         return *this;
       }
 
+      /**
+       * The text of the value without storing the text of a native number or bool, what Stringify and Save write.
+       * @param buffer used for the text of a native value, at least conversion::utility::format_buffer_size bytes
+       * @return the text, valid as long as buffer and the value
+       */
+      [[nodiscard]] std::string_view Format(char* buffer) const {
+        if (const auto len = cache_.FormatNative(buffer); len != static_cast<std::size_t>(-1)) {
+          return {buffer, len};
+        }
+        return Stored();
+      }
+
+      /**
+       * Points the value at text owned by buffer instead of copying it, copies of the value share the buffer as well.
+       * @param buffer owner of the text, kept alive as long as a value points into it
+       * @param text part of buffer, has to be followed by a '\0' for as<const char*>()
+       */
+      void Share(std::shared_ptr<const std::string> buffer, const std::string_view text) {
+        cache_.Reset();
+        value_.clear();
+        shared_ = std::shared_ptr<const char>(std::move(buffer), text.data());
+        shared_size_ = text.size();
+      }
+
     private:
-      std::string value_;
+      /// the text of the value, formatted on first use for a native value
+      mutable std::pmr::string value_;
+      /// the text of the value when it points into a buffer set by Share, value_ is empty then
+      std::shared_ptr<const char> shared_;
+      std::size_t shared_size_ = 0;
+      /// the value itself when it was assigned as a number or bool, otherwise the last successful as<T>() of a numeric or bool type
+      mutable utility::ValueCache cache_;
+
+    private:
+      std::string_view Text() const {
+        cache_.FormatOnce([this](const std::string_view text) {
+          value_.assign(text);
+        });
+        return Stored();
+      }
+
+      std::string_view Stored() const {
+        return shared_ ? std::string_view(shared_.get(), shared_size_) : std::string_view(value_);
+      }
+
+      /// @return the text in value_ unless the value is native, another thread may be formatting that
+      std::string_view StoredText() const {
+        return cache_.IsNative() ? std::string_view() : std::string_view(value_);
+      }
     };
 
-    struct IniSection {
+    struct IniSection {
+      using Items = utility::SymbolMap<IniValue>;
+      using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+      IniSection() = default;
+      explicit IniSection(const allocator_type& alloc) : items_(alloc) {}
+      /**
+       * @param symbols table the keys are interned in, a section without one makes its own on the first Add
+       */
+      IniSection(std::shared_ptr<utility::SymbolTable> symbols, const allocator_type& alloc) : items_(alloc), symbols_(std::move(symbols)) {}
+      IniSection(const IniSection& other, const allocator_type& alloc) : items_(other.items_, alloc), symbols_(other.symbols_) {}
+      IniSection(IniSection&& other, const allocator_type& alloc) : items_(std::move(other.items_), alloc), symbols_(std::move(other.symbols_)) {}
+      IniSection(const IniSection&) = default;
+      IniSection(IniSection&&) noexcept = default;
+      IniSection& operator=(const IniSection&) = default;
+      IniSection& operator=(IniSection&&) = default;
+
+      /**
+       * @tparam T type of the value to add
+       * @param key key of the value
+       * @param value value to add, a IniValue is moved without copying its text
+       */
+      template <typename T>
+      void Add(const std::string_view key, T&& value) {
+        Emplace(key) = std::forward<T>(value);
+      }
+
+      /**
+       * @tparam T type of the value to add
+       * @param key key from Parser::Intern, a symbol of another parser is interned again
+       * @param value value to add, a IniValue is moved without copying its text
+       */
+      template <typename T>
+      void Add(const Symbol& key, T&& value) {
+        Emplace(key) = std::forward<T>(value);
+      }
+
       /**
-       * @tparam T type of the value to add
        * @param key key of the value
-       * @param value value to add
+       * @return the value of key, added empty when the section does not have it
        */
-      template <typename T>
-      void Add(const std::string& key, const T& value) {
-        conversion::AsImpl<T> as;
-        std::string tmp;
-        as.set(value, tmp);
-        items_[key] = tmp;
+      IniValue& Emplace(const std::string_view key) {
+        return items_.try_emplace(Symbols().Intern(key)).first->second;
+      }
+
+      /**
+       * @param key key from Parser::Intern, a symbol of another parser is interned again
+       * @return the value of key, added empty when the section does not have it
+       */
+      IniValue& Emplace(Symbol key) {
+        if (!key || key.table() != symbols_.get()) {
+          key = Symbols().Intern(key);
+        }
+        return items_.try_emplace(std::move(key)).first->second;
       }
 
       /**
        * @param key key of value to remove
        * @return success
        */
-      bool Remove(const std::string& key) {
-        if (items_.find(key) != items_.end()) {
-          items_.erase(key);
+      bool Remove(const std::string_view key) {
+        if (const auto entry = utility::FindKey(items_, symbols_.get(), key); entry != items_.end()) {
+          items_.erase(entry);
           return true;
         }
 
-        assert(items_.find(key) != items_.end());
+        assert(utility::FindKey(items_, symbols_.get(), key) != items_.end());
         return false;
       }
 
+      /**
+       * @param other section to take the values from, a key that exists in both is overwritten
+       */
+      void Merge(IniSection&& other) {
+        if (!symbols_ && items_.empty()) {
+          symbols_ = other.symbols_;
+        }
+
+        for (auto& item : other.items_) {
+          // keys of a section with another table have to be interned in this one
+          auto key = item.first.table() == symbols_.get() ? item.first : Symbols().Intern(item.first);
+          items_.try_emplace(std::move(key)).first->second = std::move(item.second);
+        }
+        other.items_.clear();
+      }
+
       /**
        * @note This will remove all the values in the section
        */
@@ -151,20 +912,84 @@ namespace ini {
        * @param key check if the key exists in the section
        * @return true if the key exists
        */
-      [[nodiscard]] bool HasValue(const std::string& key) const {
-        return items_.find(key) != items_.end();
+      [[nodiscard]] bool HasValue(const std::string_view key) const {
+        return utility::FindKey(items_, symbols_.get(), key) != items_.end();
+      }
+
+      /**
+       * @param key key from Parser::Intern, a symbol of another parser is looked up by its string
+       * @return true if the key exists
+       */
+      [[nodiscard]] bool HasValue(const Symbol& key) const {
+        return utility::FindKey(items_, symbols_.get(), key) != items_.end();
+      }
+
+      /**
+       * @param key key of the value to find
+       * @return a pointer to the value or nullptr if the section does not have the key
+       */
+      [[nodiscard]] const IniValue* Find(const std::string_view key) const {
+        const auto entry = utility::FindKey(items_, symbols_.get(), key);
+        return entry != items_.end() ? &entry->second : nullptr;
+      }
+
+      /**
+       * Looks up every key first and converts afterwards, so a section worth of settings is read in one call.
+       * @tparam T types of the values, one per key
+       * @param keys keys of the values
+       * @return a value per key, empty when the key is missing or the value is not a T
+       */
+      template <typename... T, typename... Keys, typename = std::enable_if_t<sizeof...(T) == sizeof...(Keys)>>
+      [[nodiscard]] std::tuple<std::optional<T>...> GetMany(const Keys&... keys) const {
+        return GetManyImpl<T...>(nullptr, {std::string_view(keys)...}, std::index_sequence_for<T...>{});
+      }
+
+      /**
+       * @tparam T types of the values, one per key
+       * @param errors receives every key that is missing or not of its type
+       * @param keys keys of the values
+       * @return a value per key, empty when the key is missing or the value is not a T
+       */
+      template <typename... T, typename... Keys, typename = std::enable_if_t<sizeof...(T) == sizeof...(Keys)>>
+      [[nodiscard]] std::tuple<std::optional<T>...> GetMany(std::vector<LookupError>& errors, const Keys&... keys) const {
+        return GetManyImpl<T...>(&errors, {std::string_view(keys)...}, std::index_sequence_for<T...>{});
       }
 
       /**
        * @return a stringified version of the section
        */
       [[nodiscard]] std::string Stringify() const {
-        std::stringstream res;
-        for (auto& item : items_) {
-          res << item.first << "=" << item.second.as<std::string>() << "\n";
+        std::string res;
+        res.reserve(StringifiedSize());
+        Write(res);
+        return res;
+      }
+
+      /**
+       * @return size in bytes of the output of Stringify
+       */
+      [[nodiscard]] std::size_t StringifiedSize() const {
+        std::size_t size = 0;
+        char buffer[conversion::utility::format_buffer_size];
+        for (const auto& item : items_) {
+          size += item.first.size() + item.second.Format(buffer).size() + 2;
         }
+        return size;
+      }
 
-        return res.str();
+      /**
+       * @tparam Out std::string or utility::BufferedWriter
+       * @param out receives the same output as Stringify
+       */
+      template <typename Out>
+      void Write(Out& out) const {
+        char buffer[conversion::utility::format_buffer_size];
+        for (const auto& item : items_) {
+          out.append(item.first);
+          out.push_back('=');
+          out.append(item.second.Format(buffer));
+          out.push_back('\n');
+        }
       }
 
       /**
@@ -178,54 +1003,246 @@ namespace ini {
        * @param key key of the value to get
        * @return a reference to the key
        */
-      [[nodiscard]] IniValue& operator[](const std::string& key) {
-        const auto entry = items_.find(key);
+      [[nodiscard]] IniValue& operator[](const std::string_view key) {
+        return Get(utility::FindKey(items_, symbols_.get(), key), key);
+      }
 
-        if (entry != items_.end()) {
-          return entry->second;
-        }
+      /**
+       * @param key key of the value to get
+       * @return a reference to the key
+       */
+      [[nodiscard]] const IniValue& operator[](const std::string_view key) const {
+        return Get(utility::FindKey(items_, symbols_.get(), key), key);
+      }
 
-        assert(entry != items_.end());
-        throw std::runtime_error("Section does not have a value with the key: " + key);
+      /**
+       * @param key key from Parser::Intern, looked up without hashing the string
+       * @return a reference to the key
+       */
+      [[nodiscard]] IniValue& operator[](const Symbol& key) {
+        return Get(utility::FindKey(items_, symbols_.get(), key), key);
+      }
+
+      /**
+       * @param key key from Parser::Intern, looked up without hashing the string
+       * @return a reference to the key
+       */
+      [[nodiscard]] const IniValue& operator[](const Symbol& key) const {
+        return Get(utility::FindKey(items_, symbols_.get(), key), key);
+      }
+
+      [[nodiscard]] Items::iterator begin() noexcept {
+        return items_.begin();
       }
 
-      [[nodiscard]] std::unordered_map<std::string, IniValue>::iterator begin() noexcept {
+      [[nodiscard]] Items::const_iterator begin() const noexcept {
         return items_.begin();
       }
 
-      [[nodiscard]] std::unordered_map<std::string, IniValue>::const_iterator cbegin() const noexcept {
+      [[nodiscard]] Items::const_iterator cbegin() const noexcept {
         return items_.cbegin();
       }
 
-      [[nodiscard]] std::unordered_map<std::string, IniValue>::iterator end() noexcept {
+      [[nodiscard]] Items::iterator end() noexcept {
         return items_.end();
       }
 
-      [[nodiscard]] std::unordered_map<std::string, IniValue>::const_iterator cend() const noexcept {
+      [[nodiscard]] Items::const_iterator end() const noexcept {
+        return items_.end();
+      }
+
+      [[nodiscard]] Items::const_iterator cend() const noexcept {
         return items_.cend();
       }
 
     private:
-      std::unordered_map<std::string, IniValue> items_;
+      Items items_;
+      /// shared with the parser and every other section of it
+      std::shared_ptr<utility::SymbolTable> symbols_;
+
+    private:
+      utility::SymbolTable& Symbols() {
+        if (!symbols_) {
+          symbols_ = std::make_shared<utility::SymbolTable>(items_.get_allocator().resource());
+        }
+        return *symbols_;
+      }
+
+      template <typename Entry>
+      auto Get(const Entry entry, const std::string_view key) const -> decltype((entry->second)) {
+        if (entry != items_.end()) {
+          return entry->second;
+        }
+
+        assert(entry != items_.end());
+        throw std::runtime_error("Section does not have a value with the key: " + std::string(key));
+      }
+
+      template <typename... T, std::size_t... I>
+      std::tuple<std::optional<T>...> GetManyImpl(std::vector<LookupError>* errors, const std::array<std::string_view, sizeof...(T)>& keys, std::index_sequence<I...>) const {
+        // every lookup before the first conversion, so the lookups don't wait on each other
+        const auto entries = utility::FindKeys(items_, symbols_.get(), keys);
+        std::tuple<std::optional<T>...> res;
+        (GetOne(entries[I], std::get<I>(res), I, keys[I], errors), ...);
+        return res;
+      }
+
+      template <typename T>
+      void GetOne(const Items::const_iterator entry, std::optional<T>& out, const std::size_t index, const std::string_view key, std::vector<LookupError>* errors) const {
+        if (entry == items_.end()) {
+          if (errors) errors->push_back({LookupError::Type::Missing, index, std::string(key)});
+          return;
+        }
+
+        T value;
+        if (entry->second.TryAs(value)) {
+          out = std::move(value);
+        } else if (errors) {
+          errors->push_back({LookupError::Type::Invalid, index, std::string(key)});
+        }
+      }
+    };
+
+    using IniSections = utility::SymbolMap<IniSection>;
+
+  private:
+    struct IniRoot;
+
+  public:
+    /**
+     * A read only version of the document as it was when Publish was called.
+     * Any amount of threads can read a snapshot while the parser is being changed, without locking.
+     */
+    class Snapshot {
+    public:
+      /**
+       * @param section name of the section to check for
+       * @return returns true if the section exists
+       */
+      [[nodiscard]] bool HasSection(const std::string_view section) const {
+        return utility::FindKey(root_->sections, root_->symbols.get(), section) != root_->sections.end();
+      }
+
+      /**
+       * @param section the name of the section
+       * @param key check if the key exists in the section
+       * @return true if the key exists
+       */
+      [[nodiscard]] bool SectionHasValue(const std::string_view section, const std::string_view key) const {
+        const auto entry = utility::FindKey(root_->sections, root_->symbols.get(), section);
+        return entry != root_->sections.end() && entry->second.HasValue(key);
+      }
+
+      /**
+       * @return count of non root sections
+       */
+      [[nodiscard]] std::size_t GetSectionCount() const {
+        return root_->sections.size();
+      }
+
+      /**
+       * @return the root section
+       */
+      [[nodiscard]] const IniSection& GetRootSection() const {
+        return root_->root_section;
+      }
+
+      /**
+       * @param section name of the section to get
+       * @return the section
+       */
+      [[nodiscard]] const IniSection& GetSection(const std::string_view section) const {
+        const auto entry = utility::FindKey(root_->sections, root_->symbols.get(), section);
+
+        if (entry != root_->sections.end()) {
+          return entry->second;
+        }
+
+        assert(entry != root_->sections.end());
+        throw std::runtime_error("Section: " + std::string(section) + " does not exist");
+      }
+
+      /**
+       * @param section name of the section to get
+       * @return the section
+       */
+      [[nodiscard]] const IniSection& operator[](const std::string_view section) const {
+        return GetSection(section);
+      }
+
+      [[nodiscard]] IniSections::const_iterator begin() const noexcept {
+        return root_->sections.cbegin();
+      }
+
+      [[nodiscard]] IniSections::const_iterator end() const noexcept {
+        return root_->sections.cend();
+      }
+
+    private:
+      friend class Parser;
+      explicit Snapshot(std::shared_ptr<const IniRoot> root) : root_(std::move(root)) {}
+
+      std::shared_ptr<const IniRoot> root_;
     };
 
-    using IniSections = std::unordered_map<std::string, IniSection>;
+    /**
+     * Makes a copy of the document that GetSnapshot returns from now on, call it after parsing or editing.
+     * @note the copy is allocated from the memory resource passed to the parser and freed by the thread that drops the last snapshot of it, so the resource has to be thread safe
+     */
+    void Publish() {
+      published_.Store(std::make_shared<const IniRoot>(*root_, resource_));
+    }
+
+    /**
+     * @return the document as it was on the last Publish, safe to call from any thread while the parser is being changed
+     */
+    [[nodiscard]] Snapshot GetSnapshot() const {
+      return Snapshot(published_.Load());
+    }
 
     /**
      * @param section name of the section to add
      * @return a reference to the section
      */
-    IniSection& AddSection(const std::string& section) const {
-      root_->sections[section] = IniSection();
-      return root_->sections[section];
+    IniSection& AddSection(const std::string_view section) const {
+      const auto [entry, added] = root_->sections.try_emplace(symbols_->Intern(section), symbols_);
+      if (!added) {
+        entry->second.RemoveAll();
+      }
+      return entry->second;
+    }
+
+    /**
+     * @param str a key or section name
+     * @return the symbol of str, lookups with it skip hashing and comparing the string. Valid as long as the parser and its snapshots
+     */
+    Symbol Intern(const std::string_view str) const {
+      return symbols_->Intern(str);
     }
 
     /**
      * @param section name of the section to check for
      * @return returns true if the section exists
      */
-    [[nodiscard]] bool HasSection(const std::string& section) const {
-      return root_->sections.find(section) != root_->sections.end();
+    [[nodiscard]] bool HasSection(const std::string_view section) const {
+      return utility::FindKey(root_->sections, symbols_.get(), section) != root_->sections.end();
+    }
+
+    /**
+     * @param section name from Intern
+     * @return returns true if the section exists
+     */
+    [[nodiscard]] bool HasSection(const Symbol& section) const {
+      return utility::FindKey(root_->sections, symbols_.get(), section) != root_->sections.end();
+    }
+
+    /**
+     * @param section name of the section to find
+     * @return a pointer to the section or nullptr if it doesn't exist
+     */
+    [[nodiscard]] IniSection* FindSection(const std::string_view section) const {
+      const auto entry = utility::FindKey(root_->sections, symbols_.get(), section);
+      return entry != root_->sections.end() ? &entry->second : nullptr;
     }
 
     /**
@@ -233,7 +1250,7 @@ namespace ini {
     * @param key check if the key exists in the section 
     * @return true if the key exists
     */
-    [[nodiscard]] bool SectionHasValue(const std::string& section, const std::string& key) const {
+    [[nodiscard]] bool SectionHasValue(const std::string_view section, const std::string_view key) const {
         if (!HasSection(section)) return false;
         return GetSection(section).HasValue(key);
     }
@@ -249,9 +1266,9 @@ namespace ini {
      * @param section name of the section to remove
      * @return returns true if the section is removed
      */
-    bool RemoveSection(const std::string& section) const {
-      if (HasSection(section)) {
-        root_->sections.erase(section);
+    bool RemoveSection(const std::string_view section) const {
+      if (const auto entry = utility::FindKey(root_->sections, symbols_.get(), section); entry != root_->sections.end()) {
+        root_->sections.erase(entry);
         return true;
       }
 
@@ -264,7 +1281,7 @@ namespace ini {
     * @param key check if the key exists in the section 
     * @return true if succeeded
     */
-    bool SectionRemoveKey(const std::string& section, const std::string& key) {
+    bool SectionRemoveKey(const std::string_view section, const std::string_view key) {
         if (!HasSection(section)) return false;
         return GetSection(section).Remove(key);
     }
@@ -280,15 +1297,16 @@ namespace ini {
      * @param section name of the section to get
      * @return a reference to the section
      */
-    [[nodiscard]] IniSection& GetSection(const std::string& section) const {
-      const auto entry = root_->sections.find(section);
-
-      if (entry != root_->sections.end()) {
-        return entry->second;
-      }
+    [[nodiscard]] IniSection& GetSection(const std::string_view section) const {
+      return GetSection(utility::FindKey(root_->sections, symbols_.get(), section), section);
+    }
 
-      assert(entry != root_->sections.end());
-      throw std::runtime_error("Section: " + section + " does not exist");
+    /**
+     * @param section name from Intern
+     * @return a reference to the section
+     */
+    [[nodiscard]] IniSection& GetSection(const Symbol& section) const {
+      return GetSection(utility::FindKey(root_->sections, symbols_.get(), section), section);
     }
 
     /**
@@ -307,23 +1325,31 @@ namespace ini {
      * @param section name of the section to get
      * @return a reference to the section
      */
-    [[nodiscard]] IniSection& operator[](const std::string& section) const {
+    [[nodiscard]] IniSection& operator[](const std::string_view section) const {
+      return GetSection(section);
+    }
+
+    /**
+     * @param section name from Intern
+     * @return a reference to the section
+     */
+    [[nodiscard]] IniSection& operator[](const Symbol& section) const {
       return GetSection(section);
     }
 
-    [[nodiscard]] std::unordered_map<std::string, IniSection>::iterator begin() noexcept {
+    [[nodiscard]] IniSections::iterator begin() noexcept {
       return root_->sections.begin();
     }
 
-    [[nodiscard]] std::unordered_map<std::string, IniSection>::const_iterator cbegin() const noexcept {
+    [[nodiscard]] IniSections::const_iterator cbegin() const noexcept {
       return root_->sections.cbegin();
     }
 
-    [[nodiscard]] std::unordered_map<std::string, IniSection>::iterator end() noexcept {
+    [[nodiscard]] IniSections::iterator end() noexcept {
       return root_->sections.end();
     }
 
-    [[nodiscard]] std::unordered_map<std::string, IniSection>::const_iterator cend() const noexcept {
+    [[nodiscard]] IniSections::const_iterator cend() const noexcept {
       return root_->sections.cend();
     }
 
@@ -331,14 +1357,30 @@ namespace ini {
      * @return a string representation of the ini file
      */
     [[nodiscard]] std::string Stringify() const {
-      std::stringstream ss;
+      std::string res;
+      res.reserve(StringifiedSize());
+      Serialize(res);
+      return res;
+    }
 
-      ss << root_->root_section.Stringify();
+    /**
+     * @return size in bytes of the output of Stringify
+     */
+    [[nodiscard]] std::size_t StringifiedSize() const {
+      std::size_t size = root_->root_section.StringifiedSize();
       for (const auto& section : root_->sections) {
-        ss << "[" << section.first << "]" << std::endl;
-        ss << section.second.Stringify();
+        size += section.first.size() + 3 + section.second.StringifiedSize();
       }
-      return ss.str();
+      return size;
+    }
+
+    /**
+     * @param stream stream to write the ini file to, written in large blocks without building the whole file in memory
+     */
+    void Write(std::ostream& stream) const {
+      utility::BufferedWriter writer(stream);
+      Serialize(writer);
+      writer.Flush();
     }
 
     /**
@@ -350,199 +1392,287 @@ namespace ini {
         if (!ofs.is_open()) {
             return false;
         }
-        ofs << Stringify();
+        Write(ofs);
         ofs.close();
-        return true;
+        return !ofs.fail();
     }
 
   private:
+    /**
+     * @tparam Out std::string or utility::BufferedWriter
+     * @param out receives the same output as Stringify
+     */
+    template <typename Out>
+    void Serialize(Out& out) const {
+      root_->root_section.Write(out);
+      for (const auto& section : root_->sections) {
+        out.push_back('[');
+        out.append(section.first);
+        out.append("]\n");
+        section.second.Write(out);
+      }
+    }
+
     struct IniRoot {
+      /**
+       * @param counted allocate through a CountingResource so a measured parse can count its allocations
+       */
+      IniRoot(std::pmr::memory_resource* resource, std::shared_ptr<utility::SymbolTable> symbols, const bool counted = false)
+          : counter(counted ? std::make_unique<utility::CountingResource>(resource) : nullptr), root_section(symbols, counter ? counter.get() : resource), sections(counter ? counter.get() : resource), symbols(std::move(symbols)) {}
+      IniRoot(const IniRoot& other, std::pmr::memory_resource* resource) : root_section(other.root_section, resource), sections(other.sections, resource), symbols(other.symbols) {}
+
+      /// declared first so it outlives the sections allocated from it
+      std::unique_ptr<utility::CountingResource> counter;
       IniSection root_section;
-      std::unordered_map<std::string, IniSection> sections;
+      IniSections sections;
+      std::shared_ptr<utility::SymbolTable> symbols;
     };
 
+    [[nodiscard]] IniSection& GetSection(const IniSections::iterator entry, const std::string_view section) const {
+      if (entry != root_->sections.end()) {
+        return entry->second;
+      }
+
+      assert(entry != root_->sections.end());
+      throw std::runtime_error("Section: " + std::string(section) + " does not exist");
+    }
+
     std::string current_section_;
+    std::pmr::memory_resource* resource_;
+    /// every key and section name of every document this parser has seen, shared with its sections and snapshots
+    std::shared_ptr<utility::SymbolTable> symbols_;
     std::unique_ptr<IniRoot> root_;
+    /// what GetSnapshot returns, replaced as a whole by Publish
+    utility::AtomicSharedPtr<const IniRoot> published_;
     bool wipe_on_parse_;
+    ParseHook parse_hook_;
 
   private:
-#define TRIM_STR(str, c) TrimR(Trim(str, c), c)
-
     /**
-     * @param lines a vector of lines to parse
+     * Adds the parsed sections and items to the document of a Parser
+     * @tparam Stats utility::NoStats or ParseStats, with ParseStats every event is counted and timed
      */
-    void ImplParse(std::vector<std::string>& lines) {
-      if (wipe_on_parse_) {
-        current_section_.clear();
-        root_ = std::make_unique<IniRoot>();
-      }
-
-      if (lines.empty()) {
-        return;
+    template <typename Stats>
+    struct BasicBuilder : StreamHandler {
+      static constexpr bool collect_stats = std::is_same_v<Stats, ParseStats>;
+      using Clock = std::chrono::steady_clock;
+
+      BasicBuilder(Parser& parser, IniSection* section) : parser(parser), section(section) {}
+
+      bool OnSection(const std::string_view name) {
+        if constexpr (collect_stats) {
+          const auto start = Clock::now();
+          stats.sections++;
+          stats.duplicate_sections += parser.HasSection(name);
+          AddSection(name);
+          stats.insert += Clock::now() - start;
+        } else {
+          AddSection(name);
+        }
+        return true;
       }
 
-      for (auto&& line : lines) {
-        if (line.empty()) continue;
-
-        RemoveComment(line);
-        if (line.empty()) continue;
+      bool OnKeyValue(const std::string_view key, const std::string_view value) {
+        if (!section) {
+          assert(section);
+          throw std::runtime_error("Section does not have a value with the key: " + parser.current_section_);
+        }
 
-        auto item = GetItem(line);
-        if (!item.first.empty() && !item.second.empty()) {
-          if (current_section_.empty()) {
-            GetRootSection().Add(item.first, item.second);
-          } else if (HasSection(current_section_)) {
-            (*this)[current_section_].Add(item.first, item.second);
-          } else {
-            assert(HasSection(current_section_));
-            throw std::runtime_error("Section does not have a value with the key: " + current_section_);
-          }
-          continue;
+        if constexpr (collect_stats) {
+          const auto start = Clock::now();
+          stats.keys++;
+          stats.duplicate_keys += section->HasValue(key);
+          AddItem(key, value);
+          stats.insert += Clock::now() - start;
+        } else {
+          AddItem(key, value);
         }
+        return true;
+      }
 
-        if (auto section = GetSection(line); !section.empty()) {
-          current_section_ = section;
-          AddSection(current_section_);
-          continue;
+      bool OnComment(const std::string_view) {
+        if constexpr (collect_stats) {
+          stats.comments++;
         }
+        return true;
+      }
 
-        // if it gets to here it's an empty line
+      void AddSection(const std::string_view name) {
+        parser.current_section_ = name;
+        section = &parser.AddSection(parser.current_section_);
       }
-    }
 
-    /**
-     * @param line removes a ini comment from the given string
-     */
-    static void RemoveComment(std::string& line) {
-      for (auto&& c : line) {
-        if (c == ';' || c == '#') {
-          line.clear();
+      void AddItem(const std::string_view key, const std::string_view value) {
+        // a value that fits in the string itself costs no allocation, sharing it would only add reference counting
+        if (!buffer || value.size() <= std::pmr::string().capacity()) {
+          section->Add(key, value);
           return;
-        } else if (c != ' ') {
-          break;
         }
+
+        // the character after a value is a space, quote, line break or comment the tokenizer is done with
+        (*buffer)[static_cast<std::size_t>(value.data() - buffer->data()) + value.size()] = '\0';
+        section->Emplace(key).Share(buffer, value);
+      }
+
+      Parser& parser;
+      IniSection* section;
+      /// contents owned by the document when parsing a std::string&&, values point into it
+      std::shared_ptr<std::string> buffer;
+      Stats stats;
+    };
+
+    using Builder = BasicBuilder<utility::NoStats>;
+
+    /// Collects the sections and items of one part of a document split by ParseChunks
+    struct ChunkBuilder : StreamHandler {
+      ChunkBuilder(std::pmr::memory_resource* resource, const std::shared_ptr<utility::SymbolTable>& symbols) : resource(resource), symbols(symbols), leading(symbols, resource) {}
+
+      bool OnSection(const std::string_view name) {
+        sections.emplace_back(name, IniSection(symbols, resource));
+        return true;
       }
 
-      std::size_t pos{};
-      if (pos = line.find(';'); pos != std::string::npos) {
-        if (line[pos - 1] == ' ')
-          line.erase(pos);
-      } else if (pos = line.find('#'); pos != std::string::npos) {
-        if (line[pos - 1] == ' ')
-          line.erase(pos);
+      bool OnKeyValue(const std::string_view key, const std::string_view value) {
+        (sections.empty() ? leading : sections.back().second).Add(key, value);
+        return true;
       }
-    }
+
+      std::pmr::memory_resource* resource;
+      /// interned from every thread, the table is thread safe
+      std::shared_ptr<utility::SymbolTable> symbols;
+      /// items before the first section header, they belong to the section the previous parse ended in
+      IniSection leading;
+      /// every section header in order, a repeated name replaces the earlier one when merging
+      std::vector<std::pair<std::string_view, IniSection>> sections;
+    };
 
     /**
-     * @param line to check for a valid ini item
-     * @return if it is a valid item a kv
+     * @param contents contents of a ini file, has to stay valid until parsing is done
+     * @param threads amount of threads to use, 0 uses std::thread::hardware_concurrency()
      */
-    static std::pair<std::string, std::string> GetItem(const std::string& line) {
-      std::smatch match;
-      if (std::regex_match(line, match, std::regex(R"((.*?)\s*=\s*(.*))"))) {
-        return std::make_pair(TRIM_STR(match[1].str(), ' '), TRIM_STR(TRIM_STR(match[2].str(), '"'), ' '));
+    void ParseChunks(const std::string_view contents, unsigned threads) {
+      // below this a part isn't worth the cost of a thread
+      constexpr std::size_t min_chunk_size = 64 * 1024;
+
+      if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+      }
+      threads = static_cast<unsigned>(std::min<std::size_t>(threads, contents.size() / min_chunk_size + 1));
+
+      if (threads <= 1) {
+        auto builder = BeginParse();
+        ParseBuffer(contents, builder);
+        return;
+      }
+
+      // every part after the first starts at a section header, so only the first part can have leading items
+      std::vector<std::string_view> chunks;
+      std::size_t start = 0;
+      for (unsigned i = 1; i <= threads && start < contents.size(); i++) {
+        const auto end = i == threads ? contents.size() : tokenizer::FindSectionStart(contents, std::max(start + 1, contents.size() / threads * i));
+        chunks.push_back(contents.substr(start, end - start));
+        start = end;
+      }
+
+      std::vector<ChunkBuilder> results(chunks.size(), ChunkBuilder(resource_, symbols_));
+      std::vector<std::future<void>> workers;
+      for (std::size_t i = 1; i < chunks.size(); i++) {
+        workers.push_back(std::async(std::launch::async, [&chunks, &results, i] {
+          ParseBuffer(chunks[i], results[i]);
+        }));
+      }
+      ParseBuffer(chunks[0], results[0]);
+      for (auto& worker : workers) {
+        worker.get();
+      }
+
+      // merge in document order so repeated sections and keys resolve like a sequential parse
+      auto builder = BeginParse();
+      if (results[0].leading.Size() > 0) {
+        if (!builder.section) {
+          assert(builder.section);
+          throw std::runtime_error("Section does not have a value with the key: " + current_section_);
+        }
+        builder.section->Merge(std::move(results[0].leading));
+      }
+
+      for (auto& result : results) {
+        for (auto& [name, section] : result.sections) {
+          root_->sections.try_emplace(symbols_->Intern(name), symbols_).first->second = std::move(section);
+          current_section_ = name;
+        }
       }
-      return {};
     }
 
     /**
-     * @param line to check for a valid section
-     * @return the name of the section
+     * @return a handler that adds to the document, wiped if wipe_on_parse_ is set
      */
-    static std::string GetSection(std::string& line) {
-      Trim(line, ' ');
-      if (line.empty()) return {};
-
-      if (line[0] == '[') {
-        std::size_t search_pos = 1;
-        auto close_pos = line.find(']', search_pos);
-        while (close_pos != std::string::npos && line[close_pos - 1] == '\\') {
-          search_pos = close_pos + 1;
-          close_pos = line.find(']', search_pos);
-        }
-        return line.substr(1, close_pos - 1);
+    template <typename Stats = utility::NoStats>
+    BasicBuilder<Stats> BeginParse() {
+      if (wipe_on_parse_) {
+        current_section_.clear();
+        // only a measured parse pays for counting allocations
+        root_ = std::make_unique<IniRoot>(resource_, symbols_, BasicBuilder<Stats>::collect_stats);
       }
 
-      return {};
+      return {*this, current_section_.empty() ? &GetRootSection() : FindSection(current_section_)};
     }
 
     /**
-     * @tparam T the stream type
-     * @param stream a open stream to read from
-     * @return a vector of with the content seperated by new lines
+     * @param contents contents of a ini file
+     * @param read time it took to read contents
+     * @param buffer owner of contents when values may point into them
+     * @return statistics of the parse, also passed to the ParseHook
      */
-    template <typename T>
-    static std::vector<std::string> ReadFile(T& stream) {
-      std::string tmp;
-      std::vector<std::string> lines;
-      while (std::getline(stream, tmp)) {
-        std::smatch match;
-
-        // Check if the line contains a line-break.
-        // Split it into two lines accordingly.
-        if (std::regex_match(tmp, match, std::regex(R"((.*)\r(.*))"))) {
-            lines.emplace_back(match[1].str());
-            lines.emplace_back(match[2].str());
-        } else
-          lines.emplace_back(tmp);
-      }
-      return lines;
-    }
-
-    /**
-     * @param str to split
-     * @return a split string inside a vector
-     */
-    static std::vector<std::string> Split(const std::string& str) {
-      std::vector<std::string> res;
-      std::string tmp;
-      for (auto& ch : str) {
-        if (ch == '\n' || ch == '\r') {
-          res.emplace_back(tmp);
-          tmp.clear();
-        } else {
-          tmp.push_back(ch);
+    ParseStats ParseContents(const std::string_view contents, const std::chrono::nanoseconds read, std::shared_ptr<std::string> buffer = nullptr) {
+      // counted before parsing, parsing into a owned buffer overwrites the line breaks after values
+      // "\r\n" ends one line, a last line without a line break counts as well
+      std::size_t lines = 0;
+      for (std::size_t i = 0; i < contents.size(); i++) {
+        if (contents[i] == '\n' || (contents[i] == '\r' && (i + 1 == contents.size() || contents[i + 1] != '\n'))) {
+          lines++;
         }
       }
-      if (!tmp.empty()) {
-        res.emplace_back(tmp);
+      if (!contents.empty() && contents.back() != '\n' && contents.back() != '\r') {
+        lines++;
       }
-      return res;
-    }
 
-    /// trim the front of the string by given character
-    static std::string Trim(std::string str, char trim_c) {
-      while (str.front() == trim_c) {
-        str.erase(0, 1);
-      }
-      return str;
-    }
+      const auto start = std::chrono::steady_clock::now();
+      auto builder = BeginParse<ParseStats>();
+      const auto* counter = root_->counter.get();
+      const auto allocations = counter ? counter->Allocations() : 0;
+      builder.buffer = std::move(buffer);
+      ParseBuffer(contents, builder);
+      const auto total = std::chrono::steady_clock::now() - start;
 
-    /// trim the back of the string by given character
-    static std::string TrimR(std::string str, char trim_c) {
-      while (str.back() == trim_c) {
-        str.pop_back();
-      }
+      ParseStats stats = builder.stats;
+      stats.tokenize = std::chrono::duration_cast<std::chrono::nanoseconds>(total) - stats.insert;
+      stats.allocations = counter ? counter->Allocations() - allocations : 0;
 
-      return str;
+      stats.bytes = contents.size();
+      stats.lines = lines;
+      stats.read = read;
+
+      if (parse_hook_) {
+        parse_hook_(stats);
+      }
+      return stats;
     }
 
     /// Check if given path is a file that can be parsed
     static void CheckValidFile(const std::filesystem::path& file) {
-      if (!std::filesystem::exists(file)) {
-        assert(!std::filesystem::exists(file));
+      // one stat for both checks
+      const auto status = std::filesystem::status(file);
+      if (!std::filesystem::exists(status)) {
+        assert(!std::filesystem::exists(status));
         throw std::runtime_error("File not found");
       }
 
-      if (!std::filesystem::is_regular_file(file)) {
-        assert(!std::filesystem::is_regular_file(file));
+      if (!std::filesystem::is_regular_file(status)) {
+        assert(!std::filesystem::is_regular_file(status));
         throw std::runtime_error("Not a regular file");
       }
     }
   };
 }
-#ifdef TRIM_STR
-#undef TRIM_STR
-#endif
-
 #endif // INIREADER_HPP
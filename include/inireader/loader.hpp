@@ -0,0 +1,135 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_LOADER_HPP
+#define INIREADER_LOADER_HPP
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+#include "inireader.hpp"
+
+namespace ini {
+  /// One file of LoadFiles or LoadDirectory
+  struct LoadedFile {
+    std::filesystem::path path;
+    /// the parsed file, null when it could not be loaded
+    std::unique_ptr<Parser> parser;
+    /// why the file could not be loaded, empty when it was
+    std::string error;
+  };
+
+  namespace utility {
+    /**
+     * @param file path to a regular file, checked with a single stat
+     * @return the whole contents of the file
+     */
+    inline std::string ReadWholeFile(const std::filesystem::path& file) {
+      const auto status = std::filesystem::status(file);
+      if (!std::filesystem::exists(status)) {
+        throw std::runtime_error("File not found");
+      }
+
+      if (!std::filesystem::is_regular_file(status)) {
+        throw std::runtime_error("Not a regular file");
+      }
+
+      std::ifstream stream(file, std::ios::binary | std::ios::ate);
+      const auto size = stream.tellg();
+      if (!stream.is_open() || size < 0) {
+        throw std::runtime_error("Failed to read: " + file.string());
+      }
+
+      std::string contents(static_cast<std::size_t>(size), '\0');
+      stream.seekg(0);
+      if (!stream.read(contents.data(), static_cast<std::streamsize>(contents.size()))) {
+        throw std::runtime_error("Failed to read: " + file.string());
+      }
+      return contents;
+    }
+  }
+
+  /**
+   * Parses many small files at once, like the fragments of a conf.d directory.
+   * Every worker reads a file and parses it before taking the next one, so one worker waits on the disk while the others parse.
+   * @param paths files to load
+   * @param threads amount of threads to use, 0 uses std::thread::hardware_concurrency()
+   * @return a LoadedFile per path in the order of paths, a file that fails does not stop the others
+   * @note every file gets its own Parser that owns the contents of the file, see Parser::Parse(std::string&&, bool)
+   */
+  inline std::vector<LoadedFile> LoadFiles(const std::vector<std::filesystem::path>& paths, unsigned threads = 0) {
+    std::vector<LoadedFile> res(paths.size());
+    if (paths.empty()) {
+      return res;
+    }
+
+    if (threads == 0) {
+      threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, paths.size()));
+
+    // workers take the next file when they are done, so one large file doesn't hold up a whole share of the list
+    std::atomic<std::size_t> next{0};
+    const auto work = [&paths, &res, &next] {
+      for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < paths.size(); i = next.fetch_add(1, std::memory_order_relaxed)) {
+        auto& loaded = res[i];
+        loaded.path = paths[i];
+        try {
+          auto parser = std::make_unique<Parser>();
+          parser->Parse(utility::ReadWholeFile(paths[i]), false);
+          loaded.parser = std::move(parser);
+        } catch (const std::exception& e) {
+          loaded.error = e.what();
+        }
+      }
+    };
+
+    std::vector<std::future<void>> workers;
+    for (unsigned i = 1; i < threads; i++) {
+      workers.push_back(std::async(std::launch::async, work));
+    }
+    work();
+    for (auto& worker : workers) {
+      worker.get();
+    }
+
+    return res;
+  }
+
+  /**
+   * Loads every regular file in a directory that has the extension, sub directories are not searched.
+   * @param directory directory to load
+   * @param extension extension of the files to load including the '.', empty loads every file
+   * @param threads amount of threads to use, 0 uses std::thread::hardware_concurrency()
+   * @return a LoadedFile per file sorted by path, so the order is the same on every platform and run
+   */
+  inline std::vector<LoadedFile> LoadDirectory(const std::filesystem::path& directory, const std::string_view extension = ".ini", const unsigned threads = 0) {
+    if (!std::filesystem::is_directory(directory)) {
+      assert(!std::filesystem::is_directory(directory));
+      throw std::runtime_error("Not a directory: " + directory.string());
+    }
+
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+      if (entry.is_regular_file() && (extension.empty() || entry.path().extension() == extension)) {
+        paths.push_back(entry.path());
+      }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    return LoadFiles(paths, threads);
+  }
+}
+
+#endif // INIREADER_LOADER_HPP
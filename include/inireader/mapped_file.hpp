@@ -0,0 +1,173 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_MAPPED_FILE_HPP
+#define INIREADER_MAPPED_FILE_HPP
+#include <string_view>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ini {
+  /// A read only memory mapping of a whole file
+  class MappedFile {
+  public:
+    MappedFile() = default;
+
+    /**
+     * @param file path of the file to map
+     */
+    explicit MappedFile(const std::filesystem::path& file) {
+      if (!std::filesystem::exists(file)) {
+        assert(!std::filesystem::exists(file));
+        throw std::runtime_error("File not found");
+      }
+
+      if (!std::filesystem::is_regular_file(file)) {
+        assert(!std::filesystem::is_regular_file(file));
+        throw std::runtime_error("Not a regular file");
+      }
+
+      Map(file);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept {
+      *this = std::move(other);
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+      if (this != &other) {
+        Unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+      }
+      return *this;
+    }
+
+    ~MappedFile() {
+      Unmap();
+    }
+
+    /**
+     * @return the contents of the file, valid as long as the mapping lives
+     */
+    [[nodiscard]] std::string_view View() const noexcept {
+      return {data_, size_};
+    }
+
+    /**
+     * @return size of the mapped file in bytes
+     */
+    [[nodiscard]] std::size_t Size() const noexcept {
+      return size_;
+    }
+
+  private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+
+  private:
+#ifdef _WIN32
+    void Map(const std::filesystem::path& file) {
+      HANDLE handle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+      if (handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file");
+      }
+
+      LARGE_INTEGER size;
+      if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        throw std::runtime_error("Failed to get file size");
+      }
+
+      if (size.QuadPart == 0) {
+        CloseHandle(handle);
+        return;
+      }
+
+      HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      CloseHandle(handle);
+      if (!mapping) {
+        throw std::runtime_error("Failed to map file");
+      }
+
+      void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      CloseHandle(mapping);
+      if (!view) {
+        throw std::runtime_error("Failed to map file");
+      }
+
+      data_ = static_cast<const char*>(view);
+      size_ = static_cast<std::size_t>(size.QuadPart);
+    }
+
+    void Unmap() noexcept {
+      if (data_) {
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+        size_ = 0;
+      }
+    }
+#else
+    void Map(const std::filesystem::path& file) {
+      const int fd = ::open(file.c_str(), O_RDONLY);
+      if (fd == -1) {
+        throw std::runtime_error("Failed to open file");
+      }
+
+      struct stat st{};
+      if (::fstat(fd, &st) == -1) {
+        ::close(fd);
+        throw std::runtime_error("Failed to get file size");
+      }
+
+      if (st.st_size == 0) {
+        ::close(fd);
+        return;
+      }
+
+      void* view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if (view == MAP_FAILED) {
+        throw std::runtime_error("Failed to map file");
+      }
+
+      data_ = static_cast<const char*>(view);
+      size_ = static_cast<std::size_t>(st.st_size);
+    }
+
+    void Unmap() noexcept {
+      if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+      }
+    }
+#endif
+  };
+}
+
+#endif // INIREADER_MAPPED_FILE_HPP
@@ -0,0 +1,456 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_OVERLAY_HPP
+#define INIREADER_OVERLAY_HPP
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <stdexcept>
+#include <iterator>
+#include "inireader.hpp"
+#include "symbol.hpp"
+
+namespace ini {
+  /**
+   * Reads several parsers as one document without copying them, like defaults.ini, region.ini and host.ini.
+   * A key is read from the highest layer that has it, the sections of all layers are merged key by key.
+   * Replacing a layer, after a reload for example, leaves the other layers untouched.
+   * @note treat the layers as read only while they are in the overlay. With memoization lookups write the memo, so then only one thread may use the overlay
+   */
+  class Overlay {
+  public:
+    using Layer = std::shared_ptr<const Parser>;
+
+    /// A key and its value from the layer it resolves to
+    struct Item {
+      std::string_view key;
+      const Parser::IniValue& value;
+    };
+
+    /// A section of every layer, found by name. Valid as long as the overlay and the name it was looked up with
+    class Section {
+    public:
+      class Iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Item;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Item;
+
+        Iterator() = default;
+
+        Item operator*() const {
+          return {entry_->first, entry_->second};
+        }
+
+        Iterator& operator++() {
+          ++entry_;
+          Settle();
+          return *this;
+        }
+
+        Iterator operator++(int) {
+          auto res = *this;
+          ++*this;
+          return res;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+          return lhs.layer_ == rhs.layer_ && (lhs.layer_ == 0 || lhs.entry_ == rhs.entry_);
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+          return !(lhs == rhs);
+        }
+
+      private:
+        friend class Section;
+
+        const Section* section_ = nullptr;
+        /// one past the layer being iterated, layers are visited from the highest down. 0 at the end
+        std::size_t layer_ = 0;
+        const Parser::IniSection* current_ = nullptr;
+        Parser::IniSection::Items::const_iterator entry_;
+
+        Iterator(const Section* section, const std::size_t layer) : section_(section), layer_(layer) {
+          if (layer_ > 0) {
+            Enter();
+            Settle();
+          }
+        }
+
+        /// starts on the first item of the current layer, which may not have the section
+        void Enter() {
+          current_ = section_->InLayer(layer_ - 1);
+          if (current_) {
+            entry_ = current_->begin();
+          }
+        }
+
+        /// moves to the next item that no higher layer has, starting at entry_
+        void Settle() {
+          while (layer_ > 0) {
+            if (!current_ || entry_ == current_->end()) {
+              layer_--;
+              if (layer_ > 0) Enter();
+              continue;
+            }
+
+            if (!section_->Shadowed(entry_->first, layer_ - 1)) {
+              return;
+            }
+            ++entry_;
+          }
+        }
+      };
+
+      /**
+       * @param key key of the value to check for
+       * @return true if any layer has the key in this section
+       */
+      [[nodiscard]] bool HasValue(const std::string_view key) const {
+        return overlay_->Resolve(root_, name_, key) != nullptr;
+      }
+
+      /**
+       * @param key key of the value to find
+       * @return the value of the highest layer that has the key, or nullptr
+       */
+      [[nodiscard]] const Parser::IniValue* Find(const std::string_view key) const {
+        return overlay_->Resolve(root_, name_, key);
+      }
+
+      /**
+       * @param key key of the value to get
+       * @return the value of the highest layer that has the key
+       */
+      [[nodiscard]] const Parser::IniValue& operator[](const std::string_view key) const {
+        if (const auto* value = Find(key)) {
+          return *value;
+        }
+
+        assert(HasValue(key));
+        throw std::runtime_error("Section does not have a value with the key: " + std::string(key));
+      }
+
+      /**
+       * @return name of the section, empty for the root section
+       */
+      [[nodiscard]] std::string_view Name() const noexcept {
+        return name_;
+      }
+
+      /// every key once, with the value it resolves to. Keys of the highest layer come first
+      [[nodiscard]] Iterator begin() const {
+        return {this, overlay_->layers_.size()};
+      }
+
+      [[nodiscard]] Iterator end() const {
+        return {this, 0};
+      }
+
+    private:
+      friend class Overlay;
+
+      const Overlay* overlay_;
+      std::string_view name_;
+      bool root_;
+
+      Section(const Overlay* overlay, const std::string_view name, const bool root) : overlay_(overlay), name_(name), root_(root) {}
+
+      [[nodiscard]] const Parser::IniSection* InLayer(const std::size_t layer) const {
+        return overlay_->FindSection(layer, root_, name_);
+      }
+
+      /// @return true when a layer above layer has the key in this section
+      [[nodiscard]] bool Shadowed(const std::string_view key, const std::size_t layer) const {
+        for (std::size_t i = layer + 1; i < overlay_->layers_.size(); i++) {
+          const auto* section = InLayer(i);
+          if (section && section->HasValue(key)) {
+            return true;
+          }
+        }
+        return false;
+      }
+    };
+
+    class Iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = Section;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = Section;
+
+      Iterator() = default;
+
+      Section operator*() const {
+        return {overlay_, entry_->first, false};
+      }
+
+      Iterator& operator++() {
+        ++entry_;
+        Settle();
+        return *this;
+      }
+
+      Iterator operator++(int) {
+        auto res = *this;
+        ++*this;
+        return res;
+      }
+
+      friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+        return lhs.layer_ == rhs.layer_ && (lhs.layer_ == 0 || lhs.entry_ == rhs.entry_);
+      }
+
+      friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+        return !(lhs == rhs);
+      }
+
+    private:
+      friend class Overlay;
+
+      const Overlay* overlay_ = nullptr;
+      /// one past the layer being iterated, layers are visited from the highest down. 0 at the end
+      std::size_t layer_ = 0;
+      Parser::IniSections::const_iterator entry_;
+
+      Iterator(const Overlay* overlay, const std::size_t layer) : overlay_(overlay), layer_(layer) {
+        if (layer_ > 0) {
+          entry_ = overlay_->layers_[layer_ - 1]->cbegin();
+          Settle();
+        }
+      }
+
+      /// moves to the next section that no higher layer has, starting at entry_
+      void Settle() {
+        while (layer_ > 0) {
+          if (entry_ == overlay_->layers_[layer_ - 1]->cend()) {
+            layer_--;
+            if (layer_ > 0) entry_ = overlay_->layers_[layer_ - 1]->cbegin();
+            continue;
+          }
+
+          if (!overlay_->Shadowed(entry_->first, layer_ - 1)) {
+            return;
+          }
+          ++entry_;
+        }
+      }
+    };
+
+    /**
+     * @param layers parsers from the lowest to the highest priority, none may be null
+     * @param memoize remember which layer a key resolves to, so a repeated lookup searches one layer instead of all of them. Misses are not remembered
+     */
+    explicit Overlay(std::vector<Layer> layers = {}, const bool memoize = false) : layers_(std::move(layers)), memoize_(memoize) {
+      for (const auto& layer : layers_) {
+        CheckLayer(layer);
+      }
+    }
+
+    /**
+     * @param layer parser that takes priority over every layer added before it
+     * @return index of the layer
+     */
+    std::size_t AddLayer(Layer layer) {
+      CheckLayer(layer);
+      layers_.push_back(std::move(layer));
+      // a key the new layer has may now resolve to it, only what the lower layers resolved to can change
+      Invalidate(layers_.size() - 1);
+      return layers_.size() - 1;
+    }
+
+    /**
+     * Swaps a layer, e.g. with Watcher::Current() after a reload. Only memoized keys that resolved to this layer or a lower one are forgotten.
+     * @param index index of the layer from AddLayer or the constructor
+     * @param layer the new parser of that layer
+     */
+    void SetLayer(const std::size_t index, Layer layer) {
+      if (index >= layers_.size()) {
+        assert(index < layers_.size());
+        throw std::runtime_error("Layer " + std::to_string(index) + " does not exist");
+      }
+
+      CheckLayer(layer);
+      layers_[index] = std::move(layer);
+      Invalidate(index);
+    }
+
+    /**
+     * @param index index of the layer
+     * @return the parser of that layer
+     */
+    [[nodiscard]] const Layer& GetLayer(const std::size_t index) const {
+      return layers_.at(index);
+    }
+
+    /**
+     * @return amount of layers
+     */
+    [[nodiscard]] std::size_t GetLayerCount() const noexcept {
+      return layers_.size();
+    }
+
+    /**
+     * @param section name of the section to check for
+     * @return true if any layer has the section
+     */
+    [[nodiscard]] bool HasSection(const std::string_view section) const {
+      for (const auto& layer : layers_) {
+        if (layer->HasSection(section)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * @param section the name of the section
+     * @param key check if the key exists in the section
+     * @return true if any layer has the key in the section
+     */
+    [[nodiscard]] bool SectionHasValue(const std::string_view section, const std::string_view key) const {
+      return Resolve(false, section, key) != nullptr;
+    }
+
+    /**
+     * @return count of distinct non root sections over all layers
+     */
+    [[nodiscard]] std::size_t GetSectionCount() const {
+      return static_cast<std::size_t>(std::distance(begin(), end()));
+    }
+
+    /**
+     * @return the root sections of all layers
+     */
+    [[nodiscard]] Section GetRootSection() const {
+      return {this, {}, true};
+    }
+
+    /**
+     * @param section name of the section to get
+     * @return the section of all layers, the name has to outlive it
+     */
+    [[nodiscard]] Section GetSection(const std::string_view section) const {
+      if (HasSection(section)) {
+        return {this, section, false};
+      }
+
+      assert(HasSection(section));
+      throw std::runtime_error("Section: " + std::string(section) + " does not exist");
+    }
+
+    /**
+     * @param section name of the section to get
+     * @return the section of all layers, the name has to outlive it
+     */
+    [[nodiscard]] Section operator[](const std::string_view section) const {
+      return GetSection(section);
+    }
+
+    /// every section once, sections of the highest layer come first
+    [[nodiscard]] Iterator begin() const {
+      return {this, layers_.size()};
+    }
+
+    [[nodiscard]] Iterator end() const {
+      return {this, 0};
+    }
+
+  private:
+    static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+    std::vector<Layer> layers_;
+    bool memoize_;
+    /// names of the keys memoized lookups found and their sections, they give every pair a small number
+    mutable utility::SymbolTable symbols_;
+    /// layer a section and key pair resolves to, only pairs that some layer has
+    mutable std::unordered_map<std::uint64_t, std::size_t> memo_;
+
+  private:
+    static void CheckLayer(const Layer& layer) {
+      if (!layer) {
+        assert(layer);
+        throw std::runtime_error("Overlay layer is null");
+      }
+    }
+
+    /// forgets every memoized key that could resolve differently once layer changed
+    void Invalidate(const std::size_t layer) {
+      for (auto it = memo_.begin(); it != memo_.end();) {
+        it = it->second <= layer ? memo_.erase(it) : std::next(it);
+      }
+    }
+
+    [[nodiscard]] const Parser::IniSection* FindSection(const std::size_t layer, const bool root, const std::string_view section) const {
+      return root ? &layers_[layer]->GetRootSection() : layers_[layer]->FindSection(section);
+    }
+
+    /// @return true when a layer above layer has the section
+    [[nodiscard]] bool Shadowed(const std::string_view section, const std::size_t layer) const {
+      for (std::size_t i = layer + 1; i < layers_.size(); i++) {
+        if (layers_[i]->HasSection(section)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// @return the value of the highest layer that has the key in the section, or nullptr
+    [[nodiscard]] const Parser::IniValue* Resolve(const bool root, const std::string_view section, const std::string_view key) const {
+      if (!memoize_) {
+        return Search(root, section, key).second;
+      }
+
+      // names are only interned for keys a layer has, so a name that was never found is not in the table
+      const auto section_symbol = root ? Symbol() : symbols_.Find(section);
+      const auto key_symbol = symbols_.Find(key);
+      if ((root || section_symbol) && key_symbol) {
+        if (const auto entry = memo_.find(MemoKey(root, section_symbol, key_symbol)); entry != memo_.end()) {
+          const auto* found = FindSection(entry->second, root, section);
+          return found ? found->Find(key) : nullptr;
+        }
+      }
+
+      // misses are not remembered, arbitrary names would grow the table and the memo without bound
+      const auto [layer, value] = Search(root, section, key);
+      if (value) {
+        memo_.emplace(MemoKey(root, root ? Symbol() : symbols_.Intern(section), symbols_.Intern(key)), layer);
+      }
+      return value;
+    }
+
+    /// the root section gets 0, so its keys never collide with a section that has the same id
+    static std::uint64_t MemoKey(const bool root, const Symbol& section, const Symbol& key) {
+      const auto section_id = root ? 0 : static_cast<std::uint64_t>(section.id()) + 1;
+      return section_id << 32 | key.id();
+    }
+
+    /// @return the highest layer that has the key in the section and its value, none and nullptr if no layer has it
+    [[nodiscard]] std::pair<std::size_t, const Parser::IniValue*> Search(const bool root, const std::string_view section, const std::string_view key) const {
+      for (std::size_t i = layers_.size(); i-- > 0;) {
+        if (const auto* found = FindSection(i, root, section)) {
+          if (const auto* value = found->Find(key)) {
+            return {i, value};
+          }
+        }
+      }
+      return {none, nullptr};
+    }
+  };
+}
+
+#endif // INIREADER_OVERLAY_HPP
@@ -0,0 +1,185 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_SCHEMA_HPP
+#define INIREADER_SCHEMA_HPP
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "conversion.hpp"
+#include "stream.hpp"
+#include "mapped_file.hpp"
+
+namespace ini {
+  /// A field of a schema that could not be filled
+  struct SchemaError {
+    enum class Type {
+      /// a required key is not in the file
+      Missing,
+      /// the value can't be converted to the type of the member
+      Invalid
+    };
+
+    Type type;
+    std::string section;
+    std::string key;
+    /// the value that failed to convert, empty for Missing
+    std::string value;
+  };
+
+  /**
+   * Binds a key of a section to a member of Struct
+   * @tparam Struct struct the schema fills
+   * @tparam T type of the member, needs a conversion::AsImpl
+   */
+  template <typename Struct, typename T>
+  struct Field {
+    static_assert(!std::is_same_v<T, const char*> && !std::is_same_v<T, char*> && !std::is_same_v<T, std::string_view>, "A field has to own its value, use std::string");
+
+    /// name of the section, empty for the root section
+    std::string_view section;
+    std::string_view key;
+    T Struct::*member;
+    /// a missing optional field is not an error and leaves the member untouched
+    bool required = true;
+  };
+
+  /**
+   * @param section name of the section, empty for the root section
+   * @param key key of the value
+   * @param member member to fill
+   * @param required report the field when it is missing
+   * @return the field
+   */
+  template <typename Struct, typename T>
+  constexpr Field<Struct, T> MakeField(const std::string_view section, const std::string_view key, T Struct::*member, const bool required = true) {
+    return {section, key, member, required};
+  }
+
+  /**
+   * A list of fields known at compile time, fills a struct in one pass over the file without building a Parser.
+   * Follows the same rules as Parser: a repeated section replaces the previous one and a repeated key overwrites the previous value.
+   */
+  template <typename Struct, typename... Fields>
+  class Schema {
+  public:
+    constexpr explicit Schema(Fields... fields) : fields_(fields...) {}
+
+    /**
+     * @param contents contents of a ini file
+     * @param out struct to fill, members of fields that are missing or invalid are left untouched
+     * @return every field that could not be filled, empty on success
+     */
+    std::vector<SchemaError> Bind(const std::string_view contents, Struct& out) const {
+      Binder binder(*this);
+      ParseBuffer(contents, binder);
+      return Apply(binder, out, std::index_sequence_for<Fields...>{});
+    }
+
+    /**
+     * @param contents contents of a ini file, a literal would otherwise be ambiguous with the path overload
+     * @param out struct to fill, members of fields that are missing or invalid are left untouched
+     * @return every field that could not be filled, empty on success
+     */
+    std::vector<SchemaError> Bind(const char* contents, Struct& out) const {
+      return Bind(std::string_view(contents), out);
+    }
+
+    /**
+     * @param file path to a ini file, memory mapped while binding
+     * @param out struct to fill, members of fields that are missing or invalid are left untouched
+     * @return every field that could not be filled, empty on success
+     */
+    std::vector<SchemaError> Bind(const std::filesystem::path& file, Struct& out) const {
+      const MappedFile mapping(file);
+      return Bind(mapping.View(), out);
+    }
+
+  private:
+    static constexpr std::size_t field_count = sizeof...(Fields);
+    std::tuple<Fields...> fields_;
+
+    /// Remembers the last value of every field while the file is scanned
+    struct Binder : StreamHandler {
+      explicit Binder(const Schema& schema) : schema(schema) {
+        OnSection({});
+      }
+
+      bool OnSection(const std::string_view name) {
+        // a repeated section replaces the earlier one, so its fields are unset again
+        ForEachField([&](const std::size_t i, const auto& field) {
+          in_section[i] = field.section == name;
+          if (in_section[i]) values[i] = nullptr;
+        });
+        return true;
+      }
+
+      bool OnKeyValue(const std::string_view key, const std::string_view value) {
+        ForEachField([&](const std::size_t i, const auto& field) {
+          if (in_section[i] && field.key == key) {
+            values[i] = value.data();
+            sizes[i] = value.size();
+          }
+        });
+        return true;
+      }
+
+      template <typename F>
+      void ForEachField(F&& fn) const {
+        std::apply([&fn](const auto&... fields) {
+          std::size_t i = 0;
+          (fn(i++, fields), ...);
+        }, schema.fields_);
+      }
+
+      const Schema& schema;
+      std::array<bool, field_count> in_section{};
+      /// start of the last value of every field, nullptr while it wasn't seen
+      std::array<const char*, field_count> values{};
+      std::array<std::size_t, field_count> sizes{};
+    };
+
+    template <std::size_t... I>
+    std::vector<SchemaError> Apply(const Binder& binder, Struct& out, std::index_sequence<I...>) const {
+      std::vector<SchemaError> errors;
+      (ApplyField(std::get<I>(fields_), binder.values[I], binder.sizes[I], out, errors), ...);
+      return errors;
+    }
+
+    template <typename T>
+    static void ApplyField(const Field<Struct, T>& field, const char* data, const std::size_t size, Struct& out, std::vector<SchemaError>& errors) {
+      if (!data) {
+        if (field.required) {
+          errors.push_back({SchemaError::Type::Missing, std::string(field.section), std::string(field.key), {}});
+        }
+        return;
+      }
+
+      const std::string_view value(data, size);
+      conversion::AsImpl<T> as;
+      if (!as.is(value)) {
+        errors.push_back({SchemaError::Type::Invalid, std::string(field.section), std::string(field.key), std::string(value)});
+        return;
+      }
+      as.get(value, out.*field.member);
+    }
+  };
+
+  /**
+   * @param fields fields made with MakeField, all for the same struct
+   * @return a schema filling the struct
+   */
+  template <typename Struct, typename... T>
+  constexpr Schema<Struct, Field<Struct, T>...> MakeSchema(Field<Struct, T>... fields) {
+    return Schema<Struct, Field<Struct, T>...>(fields...);
+  }
+}
+
+#endif // INIREADER_SCHEMA_HPP
@@ -0,0 +1,192 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_SIMD_HPP
+#define INIREADER_SIMD_HPP
+#include <cstdint>
+#include <cstddef>
+
+// x86-64 always has SSE2, AVX2 is checked at runtime. Define INIREADER_NO_SIMD to only use the scalar kernels
+#if !defined(INIREADER_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define INIREADER_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define INIREADER_TARGET_AVX2
+#else
+#define INIREADER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace ini::simd {
+  /// Bit i is set when byte i of a 64 byte block is that character
+  struct BlockMasks {
+    /// '\n' or '\r'
+    std::uint64_t line_breaks = 0;
+    std::uint64_t semicolons = 0;
+    std::uint64_t hashes = 0;
+    std::uint64_t equals = 0;
+  };
+
+  enum class Level {
+    Scalar,
+    SSE2,
+    AVX2
+  };
+
+  /// classifies the 64 bytes at block
+  using Classifier = BlockMasks (*)(const char* block);
+
+  /**
+   * @param mask a non zero mask
+   * @return index of the lowest set bit
+   */
+  inline unsigned TrailingZeros(const std::uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+  }
+
+  namespace scalar {
+    inline BlockMasks Classify(const char* block) {
+      BlockMasks masks;
+      for (unsigned i = 0; i < 64; i++) {
+        const std::uint64_t bit = 1ull << i;
+        switch (block[i]) {
+          case '\n':
+          case '\r':
+            masks.line_breaks |= bit;
+            break;
+          case ';':
+            masks.semicolons |= bit;
+            break;
+          case '#':
+            masks.hashes |= bit;
+            break;
+          case '=':
+            masks.equals |= bit;
+            break;
+          default:
+            break;
+        }
+      }
+      return masks;
+    }
+  }
+
+#ifdef INIREADER_SIMD_X86
+  namespace sse2 {
+    inline BlockMasks Classify(const char* block) {
+      const __m128i newline = _mm_set1_epi8('\n');
+      const __m128i carriage_return = _mm_set1_epi8('\r');
+      const __m128i semicolon = _mm_set1_epi8(';');
+      const __m128i hash = _mm_set1_epi8('#');
+      const __m128i equals = _mm_set1_epi8('=');
+
+      BlockMasks masks;
+      for (unsigned i = 0; i < 4; i++) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        const auto mask = [&bytes](const __m128i c) {
+          return static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, c))));
+        };
+        masks.line_breaks |= (mask(newline) | mask(carriage_return)) << (i * 16);
+        masks.semicolons |= mask(semicolon) << (i * 16);
+        masks.hashes |= mask(hash) << (i * 16);
+        masks.equals |= mask(equals) << (i * 16);
+      }
+      return masks;
+    }
+  }
+
+  namespace avx2 {
+    INIREADER_TARGET_AVX2 inline std::uint64_t Mask(const __m256i low, const __m256i high, const __m256i c) {
+      const auto low_mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, c)));
+      const auto high_mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, c)));
+      return low_mask | static_cast<std::uint64_t>(high_mask) << 32;
+    }
+
+    INIREADER_TARGET_AVX2 inline BlockMasks Classify(const char* block) {
+      const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+      const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+      BlockMasks masks;
+      masks.line_breaks = Mask(low, high, _mm256_set1_epi8('\n')) | Mask(low, high, _mm256_set1_epi8('\r'));
+      masks.semicolons = Mask(low, high, _mm256_set1_epi8(';'));
+      masks.hashes = Mask(low, high, _mm256_set1_epi8('#'));
+      masks.equals = Mask(low, high, _mm256_set1_epi8('='));
+      return masks;
+    }
+  }
+#endif
+
+  /**
+   * @param level instruction set
+   * @return true if this build and cpu can use level
+   */
+  inline bool Supported(const Level level) {
+    switch (level) {
+      case Level::Scalar:
+        return true;
+#ifdef INIREADER_SIMD_X86
+      case Level::SSE2:
+        return true;
+      case Level::AVX2: {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        // the os has to save the ymm registers as well
+        const bool avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return avx && (info[1] & (1 << 5));
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+      }
+#endif
+      default:
+        return false;
+    }
+  }
+
+  /**
+   * @param level a supported instruction set
+   * @return the classifier using level
+   */
+  inline Classifier GetClassifier(const Level level) {
+    switch (level) {
+#ifdef INIREADER_SIMD_X86
+      case Level::AVX2:
+        return avx2::Classify;
+      case Level::SSE2:
+        return sse2::Classify;
+#endif
+      default:
+        return scalar::Classify;
+    }
+  }
+
+  /**
+   * @return the best instruction set of this cpu, detected once
+   */
+  inline Level ActiveLevel() {
+    static const Level level = [] {
+      for (const auto candidate : {Level::AVX2, Level::SSE2}) {
+        if (Supported(candidate)) return candidate;
+      }
+      return Level::Scalar;
+    }();
+    return level;
+  }
+}
+
+#endif // INIREADER_SIMD_HPP
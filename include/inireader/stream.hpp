@@ -0,0 +1,166 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_STREAM_HPP
+#define INIREADER_STREAM_HPP
+#include <string_view>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+#include "tokenizer.hpp"
+
+namespace ini {
+  /**
+   * Default callbacks for ParseStream and ParseBuffer, derive from it and hide the ones you need.
+   * Every callback returns false to stop parsing, the views are only valid during the call.
+   */
+  struct StreamHandler {
+    /**
+     * @param name name of the section
+     */
+    bool OnSection(std::string_view /*name*/) {
+      return true;
+    }
+
+    /**
+     * @param key key of the item
+     * @param value value of the item
+     */
+    bool OnKeyValue(std::string_view /*key*/, std::string_view /*value*/) {
+      return true;
+    }
+
+    /**
+     * @param comment the comment including the leading ';' or '#', called after the section or item on the same line
+     */
+    bool OnComment(std::string_view /*comment*/) {
+      return true;
+    }
+  };
+
+  namespace utility {
+    /// Collects small writes in a fixed buffer so the stream only sees large writes, has the append interface of std::string
+    class BufferedWriter {
+    public:
+      /**
+       * @param stream stream to write to
+       * @param size size of the buffer in bytes
+       */
+      explicit BufferedWriter(std::ostream& stream, const std::size_t size = 64 * 1024) : stream_(stream), buffer_(size > 0 ? size : 1) {}
+
+      BufferedWriter(const BufferedWriter&) = delete;
+      BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+      void append(const std::string_view str) {
+        if (str.size() > buffer_.size() - used_) {
+          Flush();
+          if (str.size() >= buffer_.size()) {
+            stream_.write(str.data(), static_cast<std::streamsize>(str.size()));
+            return;
+          }
+        }
+
+        std::memcpy(buffer_.data() + used_, str.data(), str.size());
+        used_ += str.size();
+      }
+
+      void push_back(const char c) {
+        if (used_ == buffer_.size()) {
+          Flush();
+        }
+        buffer_[used_++] = c;
+      }
+
+      /// write everything that is buffered to the stream, has to be called before the writer is destroyed
+      void Flush() {
+        stream_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+        used_ = 0;
+      }
+
+    private:
+      std::ostream& stream_;
+      std::vector<char> buffer_;
+      std::size_t used_ = 0;
+    };
+
+    /**
+     * @return false if the handler wants to stop
+     */
+    template <typename Handler>
+    bool DispatchLine(const std::string_view line, const tokenizer::Delimiters& delimiters, Handler& handler) {
+      const auto token = tokenizer::ScanLine(line, delimiters);
+      switch (token.type) {
+        case tokenizer::TokenType::Item:
+          if (!handler.OnKeyValue(token.key, token.value)) return false;
+          break;
+        case tokenizer::TokenType::Section:
+          if (!handler.OnSection(token.key)) return false;
+          break;
+        case tokenizer::TokenType::Comment:
+        case tokenizer::TokenType::Empty:
+          break;
+      }
+
+      return token.comment.empty() || handler.OnComment(token.comment);
+    }
+  }
+
+  /**
+   * @tparam Handler a type with the callbacks of StreamHandler
+   * @param buffer contents of a ini file
+   * @param handler receives the sections, items and comments in order
+   * @return false if the handler stopped parsing
+   */
+  template <typename Handler>
+  bool ParseBuffer(const std::string_view buffer, Handler& handler) {
+    return tokenizer::ScanLines(buffer, [&handler](const std::string_view line, const tokenizer::Delimiters& delimiters) {
+      return utility::DispatchLine(line, delimiters, handler);
+    });
+  }
+
+  /**
+   * @tparam Handler a type with the callbacks of StreamHandler
+   * @param stream a open stream of a ini file, read in chunks so memory stays constant regardless of the input size
+   * @param handler receives the sections, items and comments in order
+   * @param chunk_size bytes read at once, grows only when a single line is longer
+   * @return false if the handler stopped parsing
+   */
+  template <typename Handler>
+  bool ParseStream(std::istream& stream, Handler& handler, const std::size_t chunk_size = 64 * 1024) {
+    std::vector<char> buffer(chunk_size > 0 ? chunk_size : 1);
+    std::size_t filled = 0;
+
+    while (true) {
+      if (filled == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+      }
+
+      stream.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+      const auto read = static_cast<std::size_t>(stream.gcount());
+      filled += read;
+
+      const std::string_view data(buffer.data(), filled);
+      const auto dispatch = [&handler](const std::string_view line, const tokenizer::Delimiters& delimiters) {
+        return utility::DispatchLine(line, delimiters, handler);
+      };
+
+      if (read == 0) {
+        return tokenizer::ScanLines(data, dispatch);
+      }
+
+      std::size_t start = 0;
+      if (!tokenizer::ScanLines(data, dispatch, &start)) return false;
+
+      // keep the incomplete last line for the next chunk, it is scanned again once it is complete
+      std::memmove(buffer.data(), buffer.data() + start, filled - start);
+      filled -= start;
+    }
+  }
+}
+
+#endif // INIREADER_STREAM_HPP
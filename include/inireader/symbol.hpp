@@ -0,0 +1,281 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_SYMBOL_HPP
+#define INIREADER_SYMBOL_HPP
+#include <string_view>
+#include <memory_resource>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+namespace ini {
+  namespace utility {
+    class SymbolTable;
+  }
+
+  /**
+   * A string stored once in a utility::SymbolTable, compares and hashes by identity instead of by its characters.
+   * Reads like a std::string_view, the characters live as long as the table.
+   * @note symbols of different tables are never equal, even for the same string
+   */
+  class Symbol {
+  public:
+    /// a symbol that is in no table, no key or section has it
+    Symbol() = default;
+
+    /**
+     * @return id of the symbol, ids of a table count up from 0
+     */
+    [[nodiscard]] std::uint32_t id() const noexcept {
+      return entry_ ? entry_->id : 0;
+    }
+
+    /**
+     * @return the table the symbol is from, null for a empty symbol
+     */
+    [[nodiscard]] const utility::SymbolTable* table() const noexcept {
+      return entry_ ? entry_->table : nullptr;
+    }
+
+    /**
+     * @return false for a default constructed symbol, like the result of SymbolTable::Find for a unknown string
+     */
+    explicit operator bool() const noexcept {
+      return entry_ != nullptr;
+    }
+
+    [[nodiscard]] const char* data() const noexcept {
+      return entry_ ? reinterpret_cast<const char*>(entry_ + 1) : "";
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+      return entry_ ? entry_->size : 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+      return size() == 0;
+    }
+
+    [[nodiscard]] const char* begin() const noexcept {
+      return data();
+    }
+
+    [[nodiscard]] const char* end() const noexcept {
+      return data() + size();
+    }
+
+    [[nodiscard]] std::string_view View() const noexcept {
+      return {data(), size()};
+    }
+
+    operator std::string_view() const noexcept {
+      return View();
+    }
+
+    friend bool operator==(const Symbol& lhs, const Symbol& rhs) noexcept {
+      return lhs.entry_ == rhs.entry_;
+    }
+
+    friend bool operator!=(const Symbol& lhs, const Symbol& rhs) noexcept {
+      return lhs.entry_ != rhs.entry_;
+    }
+
+    friend bool operator==(const Symbol& lhs, const std::string_view rhs) noexcept {
+      return lhs.View() == rhs;
+    }
+
+    friend bool operator==(const std::string_view lhs, const Symbol& rhs) noexcept {
+      return lhs == rhs.View();
+    }
+
+    friend bool operator!=(const Symbol& lhs, const std::string_view rhs) noexcept {
+      return lhs.View() != rhs;
+    }
+
+    friend bool operator!=(const std::string_view lhs, const Symbol& rhs) noexcept {
+      return lhs != rhs.View();
+    }
+
+    friend std::ostream& operator<<(std::ostream& stream, const Symbol& symbol) {
+      return stream << symbol.View();
+    }
+
+  private:
+    friend class utility::SymbolTable;
+
+    /// the characters follow the entry in the same allocation
+    struct Entry {
+      std::size_t hash;
+      const utility::SymbolTable* table;
+      std::uint32_t id;
+      std::uint32_t size;
+    };
+
+    explicit Symbol(const Entry* entry) : entry_(entry) {}
+
+    const Entry* entry_ = nullptr;
+  };
+
+  namespace utility {
+    /// Hashes a symbol by its id, the bits are mixed so ids that are close don't end up in the same bucket
+    struct SymbolHash {
+      std::size_t operator()(const Symbol& symbol) const noexcept {
+        return static_cast<std::size_t>((symbol.id() * 0x9E3779B97F4A7C15ull) >> 32);
+      }
+    };
+
+    /**
+     * Stores every distinct string once and gives it a Symbol, used for the keys and section names of a Parser.
+     * Find never locks and can run on any amount of threads, Intern locks only when the string is new.
+     * @note strings are never removed, the table grows with every distinct string it has seen
+     */
+    class SymbolTable {
+    public:
+      /**
+       * @param resource memory resource the strings are stored in, has to outlive the table and be thread safe when Intern is called from multiple threads
+       */
+      explicit SymbolTable(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : arena_(resource), resource_(resource) {
+        index_.store(NewIndex(16), std::memory_order_relaxed);
+      }
+
+      SymbolTable(const SymbolTable&) = delete;
+      SymbolTable& operator=(const SymbolTable&) = delete;
+
+      ~SymbolTable() {
+        for (const auto& index : indexes_) {
+          resource_->deallocate(index.slots, index.capacity * sizeof(Slot), alignof(Slot));
+        }
+      }
+
+      /**
+       * @param str string to look up
+       * @return the symbol of str, a empty symbol if str was never interned
+       */
+      [[nodiscard]] Symbol Find(const std::string_view str) const noexcept {
+        return Find(*index_.load(std::memory_order_acquire), str, Hash(str));
+      }
+
+      /**
+       * @param str string to add
+       * @return the symbol of str, the same symbol on every call with an equal string
+       */
+      Symbol Intern(const std::string_view str) {
+        const auto hash = Hash(str);
+        if (const auto symbol = Find(*index_.load(std::memory_order_acquire), str, hash)) {
+          return symbol;
+        }
+
+        std::lock_guard lock(mutex_);
+        // another thread may have added it while this one waited
+        Index* index = index_.load(std::memory_order_relaxed);
+        if (const auto symbol = Find(*index, str, hash)) {
+          return symbol;
+        }
+
+        if (str.size() > std::numeric_limits<std::uint32_t>::max() || size_ == std::numeric_limits<std::uint32_t>::max()) {
+          throw std::runtime_error("Too many or too large strings to intern");
+        }
+
+        if ((static_cast<std::size_t>(size_) + 1) * 2 > index->capacity) {
+          index = Grow(*index);
+        }
+
+        // the entry and its characters are one allocation from the arena
+        void* memory = arena_.allocate(sizeof(Entry) + str.size(), alignof(Entry));
+        str.copy(static_cast<char*>(memory) + sizeof(Entry), str.size());
+        const auto* entry = new (memory) Entry{hash, this, size_++, static_cast<std::uint32_t>(str.size())};
+
+        index->slots[Probe(*index, hash)].store(entry, std::memory_order_release);
+        return Symbol(entry);
+      }
+
+      /**
+       * @return amount of distinct strings
+       */
+      [[nodiscard]] std::size_t Size() const {
+        std::lock_guard lock(mutex_);
+        return size_;
+      }
+
+    private:
+      using Entry = Symbol::Entry;
+      using Slot = std::atomic<const Entry*>;
+
+      struct Index {
+        Slot* slots;
+        std::size_t capacity;
+      };
+
+      /// only touched while holding mutex_
+      std::pmr::monotonic_buffer_resource arena_;
+      std::pmr::memory_resource* resource_;
+      mutable std::mutex mutex_;
+      std::uint32_t size_ = 0;
+      /// the index readers probe, replaced when it grows
+      std::atomic<Index*> index_;
+      /// every index ever used, a reader may still probe an old one so they are freed with the table
+      std::deque<Index> indexes_;
+
+    private:
+      static std::size_t Hash(const std::string_view str) noexcept {
+        return std::hash<std::string_view>{}(str);
+      }
+
+      static Symbol Find(const Index& index, const std::string_view str, const std::size_t hash) noexcept {
+        const std::size_t mask = index.capacity - 1;
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+          const Entry* entry = index.slots[i].load(std::memory_order_acquire);
+          if (!entry) {
+            return {};
+          }
+
+          if (entry->hash == hash && Symbol(entry).View() == str) {
+            return Symbol(entry);
+          }
+        }
+      }
+
+      /// @return the first empty slot on the probe sequence of hash
+      static std::size_t Probe(const Index& index, const std::size_t hash) noexcept {
+        const std::size_t mask = index.capacity - 1;
+        std::size_t i = hash & mask;
+        while (index.slots[i].load(std::memory_order_relaxed)) {
+          i = (i + 1) & mask;
+        }
+        return i;
+      }
+
+      Index* NewIndex(const std::size_t capacity) {
+        auto* slots = static_cast<Slot*>(resource_->allocate(capacity * sizeof(Slot), alignof(Slot)));
+        for (std::size_t i = 0; i < capacity; i++) {
+          new (slots + i) Slot(nullptr);
+        }
+        indexes_.push_back({slots, capacity});
+        return &indexes_.back();
+      }
+
+      Index* Grow(const Index& old) {
+        Index* index = NewIndex(old.capacity * 2);
+        for (std::size_t i = 0; i < old.capacity; i++) {
+          if (const Entry* entry = old.slots[i].load(std::memory_order_relaxed)) {
+            index->slots[Probe(*index, entry->hash)].store(entry, std::memory_order_relaxed);
+          }
+        }
+        index_.store(index, std::memory_order_release);
+        return index;
+      }
+    };
+  }
+}
+
+#endif // INIREADER_SYMBOL_HPP
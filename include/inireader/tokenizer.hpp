@@ -0,0 +1,266 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_TOKENIZER_HPP
+#define INIREADER_TOKENIZER_HPP
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "simd.hpp"
+
+namespace ini::tokenizer {
+  enum class TokenType {
+    Empty,
+    Section,
+    Item,
+    Comment
+  };
+
+  struct Token {
+    TokenType type = TokenType::Empty;
+    /// name of the section or key of the item
+    std::string_view key;
+    /// value of the item, empty for sections
+    std::string_view value;
+    /// comment on the line starting at the ';' or '#', for a Comment token this is the whole comment
+    std::string_view comment;
+  };
+
+  /// First position of every delimiter ScanLine looks for in a line, npos when the line doesn't have it
+  struct Delimiters {
+    std::size_t semicolon = std::string_view::npos;
+    std::size_t hash = std::string_view::npos;
+    std::size_t eq = std::string_view::npos;
+  };
+
+  namespace utility {
+    /// whitespace as matched by \s in the old regex based parser (line breaks are already split off)
+    constexpr bool IsSpace(const char c) {
+      return c == ' ' || c == '\t' || c == '\f' || c == '\v' || c == '\r';
+    }
+
+    /// trim the front of the view by given character
+    constexpr std::string_view Trim(std::string_view str, const char trim_c) {
+      while (!str.empty() && str.front() == trim_c) {
+        str.remove_prefix(1);
+      }
+      return str;
+    }
+
+    /// trim the back of the view by given character
+    constexpr std::string_view TrimR(std::string_view str, const char trim_c) {
+      while (!str.empty() && str.back() == trim_c) {
+        str.remove_suffix(1);
+      }
+      return str;
+    }
+
+    /// trim both sides of the view by given character
+    constexpr std::string_view TrimBoth(std::string_view str, const char trim_c) {
+      return TrimR(Trim(str, trim_c), trim_c);
+    }
+  }
+
+  /**
+   * @param line a single line without line breaks
+   * @return the first ';', '#' and '=' of the line
+   */
+  constexpr Delimiters FindDelimiters(const std::string_view line) {
+    Delimiters res;
+    for (std::size_t i = 0; i < line.size(); i++) {
+      const char c = line[i];
+      if (c == ';') {
+        if (res.semicolon == std::string_view::npos) res.semicolon = i;
+      } else if (c == '#') {
+        if (res.hash == std::string_view::npos) res.hash = i;
+      } else if (c == '=') {
+        if (res.eq == std::string_view::npos) res.eq = i;
+      }
+    }
+    return res;
+  }
+
+  /**
+   * @param line a single line without line breaks
+   * @param delimiters FindDelimiters of the line, ScanLines finds them for every line while splitting
+   * @return the section or item found on the line
+   * @note comments start with ';' or '#' at the start of the line or after a space.
+   * Only the first ';' is considered, '#' is only considered if there is no ';' on the line.
+   */
+  constexpr Token ScanLine(std::string_view line, const Delimiters& delimiters) {
+    constexpr auto npos = std::string_view::npos;
+
+    // only spaces may come before a comment that takes the whole line
+    std::size_t first = 0;
+    while (first < line.size() && line[first] == ' ') first++;
+    if (first < line.size() && (line[first] == ';' || line[first] == '#')) {
+      return {TokenType::Comment, {}, {}, line.substr(first)};
+    }
+
+    const std::size_t first_eq = delimiters.eq;
+
+    // cut the trailing comment, only when preceded by a space
+    std::string_view comment;
+    std::size_t comment_pos = delimiters.semicolon != npos ? delimiters.semicolon : delimiters.hash;
+    if (comment_pos != npos && line[comment_pos - 1] == ' ') {
+      comment = line.substr(comment_pos);
+      line = line.substr(0, comment_pos);
+    }
+
+    if (line.empty()) {
+      return {};
+    }
+
+    if (first_eq < line.size()) {
+      std::string_view key = line.substr(0, first_eq);
+      while (!key.empty() && utility::IsSpace(key.back())) {
+        key.remove_suffix(1);
+      }
+      key = utility::TrimBoth(key, ' ');
+
+      std::string_view value = line.substr(first_eq + 1);
+      while (!value.empty() && utility::IsSpace(value.front())) {
+        value.remove_prefix(1);
+      }
+      value = utility::TrimBoth(utility::TrimBoth(value, '"'), ' ');
+
+      if (!key.empty() && !value.empty()) {
+        return {TokenType::Item, key, value, comment};
+      }
+    }
+
+    if (line[0] == '[') {
+      std::size_t close_pos = line.find(']', 1);
+      while (close_pos != npos && line[close_pos - 1] == '\\') {
+        close_pos = line.find(']', close_pos + 1);
+      }
+
+      const std::string_view section = line.substr(1, close_pos == npos ? npos : close_pos - 1);
+      if (!section.empty()) {
+        return {TokenType::Section, section, {}, comment};
+      }
+    }
+
+    // if it gets to here it's an empty line
+    return {TokenType::Empty, {}, {}, comment};
+  }
+
+  /**
+   * @param line a single line without line breaks
+   * @return the section or item found on the line
+   * @note comments start with ';' or '#' at the start of the line or after a space.
+   * Only the first ';' is considered, '#' is only considered if there is no ';' on the line.
+   */
+  constexpr Token ScanLine(const std::string_view line) {
+    return ScanLine(line, FindDelimiters(line));
+  }
+
+  /**
+   * Splits the buffer into lines and finds the delimiters of every line in the same pass, 64 bytes at a time.
+   * @tparam F callable taking a std::string_view line without the line break and its Delimiters, returns false to stop
+   * @param buffer text to split, both '\n' and '\r' end a line
+   * @param fn called for every line
+   * @param tail when not nullptr a last line without line break is not passed to fn, its offset is stored here instead (buffer.size() if there is none)
+   * @param level instruction set to use, the best one of the cpu by default
+   * @return false if fn stopped
+   */
+  template <typename F>
+  bool ScanLines(const std::string_view buffer, F&& fn, std::size_t* tail = nullptr, const simd::Level level = simd::ActiveLevel()) {
+    constexpr auto npos = std::string_view::npos;
+    const auto classify = simd::GetClassifier(level);
+
+    // first delimiters of the current line, relative to the buffer
+    Delimiters found;
+    const auto record = [&found](const simd::BlockMasks& masks, const std::uint64_t range, const std::size_t offset) {
+      if (found.semicolon == npos && (masks.semicolons & range)) found.semicolon = offset + simd::TrailingZeros(masks.semicolons & range);
+      if (found.hash == npos && (masks.hashes & range)) found.hash = offset + simd::TrailingZeros(masks.hashes & range);
+      if (found.eq == npos && (masks.equals & range)) found.eq = offset + simd::TrailingZeros(masks.equals & range);
+    };
+    const auto relative = [&found](const std::size_t start) {
+      return Delimiters{found.semicolon == npos ? npos : found.semicolon - start, found.hash == npos ? npos : found.hash - start, found.eq == npos ? npos : found.eq - start};
+    };
+
+    std::size_t start = 0;
+    for (std::size_t offset = 0; offset < buffer.size(); offset += 64) {
+      simd::BlockMasks masks;
+      if (buffer.size() - offset >= 64) {
+        masks = classify(buffer.data() + offset);
+      } else {
+        // the last partial block is padded with zeros, which match nothing
+        char last[64] = {};
+        std::memcpy(last, buffer.data() + offset, buffer.size() - offset);
+        masks = classify(last);
+      }
+
+      for (std::uint64_t breaks = masks.line_breaks; breaks != 0; breaks &= breaks - 1) {
+        const unsigned bit = simd::TrailingZeros(breaks);
+        const std::uint64_t before = (1ull << bit) - 1;
+        record(masks, before, offset);
+
+        const std::size_t end = offset + bit;
+        if (!fn(buffer.substr(start, end - start), relative(start))) return false;
+        start = end + 1;
+        found = {};
+
+        // the rest of the block belongs to the next lines
+        const std::uint64_t rest = ~(before | (1ull << bit));
+        masks.semicolons &= rest;
+        masks.hashes &= rest;
+        masks.equals &= rest;
+      }
+      record(masks, ~0ull, offset);
+    }
+
+    if (tail) {
+      *tail = start < buffer.size() ? start : buffer.size();
+      return true;
+    }
+    return start >= buffer.size() || fn(buffer.substr(start), relative(start));
+  }
+
+  /**
+   * @tparam F callable taking a std::string_view
+   * @param buffer text to split, both '\n' and '\r' end a line
+   * @param fn called for every line without the line break
+   */
+  template <typename F>
+  void SplitLines(const std::string_view buffer, F&& fn) {
+    ScanLines(buffer, [&fn](const std::string_view line, const Delimiters&) {
+      fn(line);
+      return true;
+    });
+  }
+
+  /**
+   * @param buffer text to search
+   * @param from offset to start at, a line that is already started is skipped
+   * @return offset of the first line at or after from that is a section header, buffer.size() if there is none
+   */
+  constexpr std::size_t FindSectionStart(const std::string_view buffer, std::size_t from) {
+    const auto next_line = [&buffer](std::size_t i) {
+      while (i < buffer.size() && buffer[i] != '\n' && buffer[i] != '\r') i++;
+      return i + 1;
+    };
+
+    if (from > 0 && from < buffer.size() && buffer[from - 1] != '\n' && buffer[from - 1] != '\r') {
+      from = next_line(from);
+    }
+
+    for (; from < buffer.size(); from = next_line(from)) {
+      if (buffer[from] != '[') continue;
+
+      const auto end = next_line(from) - 1;
+      if (ScanLine(buffer.substr(from, end - from)).type == TokenType::Section) {
+        return from;
+      }
+    }
+
+    return buffer.size();
+  }
+}
+
+#endif // INIREADER_TOKENIZER_HPP
@@ -0,0 +1,311 @@
+//
+// Created by X-ray on 10/16/2026.
+//
+
+#pragma once
+
+#ifndef INIREADER_WATCHER_HPP
+#define INIREADER_WATCHER_HPP
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <cerrno>
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+#include <iterator>
+#include "inireader.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace ini {
+  /**
+   * Keeps a parsed ini file up to date. A change is parsed in the background into a new Parser which then replaces the current one,
+   * readers keep the Parser they got from Current() alive for as long as they use it so a reload never tears down a document in use.
+   * Uses inotify on Linux and checks the modification time on other platforms.
+   * @note treat the published parsers as read only, they are shared between threads
+   */
+  class Watcher {
+  public:
+    using Callback = std::function<void(const std::shared_ptr<const Parser>&)>;
+    /// receives why a reload failed, the current parser stays published
+    using ErrorCallback = std::function<void(const std::string&)>;
+
+    /**
+     * @param file path to a ini file, parsed before the constructor returns
+     * @param callback called on the watcher thread with every newly published parser, an exception it throws is reported like a failed reload
+     * @param debounce a reload waits until no change was seen for this long, so a burst of writes is parsed once
+     * @param on_error called on the watcher thread when a reload or the callback fails, exceptions it throws are ignored
+     */
+    explicit Watcher(std::filesystem::path file, Callback callback = {}, const std::chrono::milliseconds debounce = std::chrono::milliseconds(50), ErrorCallback on_error = {})
+        : file_(std::move(file)), callback_(std::move(callback)), on_error_(std::move(on_error)), debounce_(debounce) {
+      if (!std::filesystem::exists(file_)) {
+        assert(!std::filesystem::exists(file_));
+        throw std::runtime_error("File not found");
+      }
+
+      if (!std::filesystem::is_regular_file(file_)) {
+        assert(!std::filesystem::is_regular_file(file_));
+        throw std::runtime_error("Not a regular file");
+      }
+
+      const bool loaded = Reload();
+      if (!loaded) {
+        assert(loaded);
+        throw std::runtime_error(LastError());
+      }
+
+      Start();
+    }
+
+    Watcher(const Watcher&) = delete;
+    Watcher& operator=(const Watcher&) = delete;
+
+    ~Watcher() {
+      Stop();
+    }
+
+    /**
+     * @return the latest parsed version of the file
+     */
+    [[nodiscard]] std::shared_ptr<const Parser> Current() const {
+      return current_.Load();
+    }
+
+    /**
+     * @return how often the file was parsed and published, including the first time
+     */
+    [[nodiscard]] std::size_t Reloads() const {
+      return reloads_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return why the last reload or callback failed, empty once a later reload succeeded
+     */
+    [[nodiscard]] std::string LastError() const {
+      std::lock_guard lock(error_mutex_);
+      return last_error_;
+    }
+
+  private:
+    std::filesystem::path file_;
+    Callback callback_;
+    ErrorCallback on_error_;
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
+    std::chrono::milliseconds debounce_;
+    utility::AtomicSharedPtr<const Parser> current_;
+    std::atomic<std::size_t> reloads_{0};
+    /// hash of the contents current_ was parsed from
+    std::uint64_t hash_ = 0;
+    std::thread thread_;
+
+#ifdef __linux__
+    int inotify_ = -1;
+    /// written to wake up the watcher thread when stopping
+    int stop_ = -1;
+#else
+    std::mutex mutex_;
+    std::condition_variable stop_cv_;
+    bool stop_ = false;
+#endif
+
+  private:
+    /**
+     * @return true if the file was read, it is only parsed and published when the contents changed
+     */
+    bool Reload() {
+      std::string contents;
+      try {
+        std::ifstream ini_file(file_, std::ios::binary);
+        if (!ini_file.is_open()) {
+          Fail("Failed to read: " + file_.string());
+          return false;
+        }
+        contents.assign(std::istreambuf_iterator<char>(ini_file), std::istreambuf_iterator<char>());
+      } catch (const std::exception& e) {
+        Fail("Failed to read: " + file_.string() + ": " + e.what());
+        return false;
+      }
+
+      const auto hash = utility::HashContents(contents);
+      if (reloads_.load(std::memory_order_relaxed) > 0 && hash == hash_) {
+        SetError({});
+        return true;
+      }
+
+      auto parser = std::make_shared<Parser>();
+      try {
+        parser->Parse(std::move(contents), false);
+      } catch (const std::exception& e) {
+        Fail("Failed to parse: " + file_.string() + ": " + e.what());
+        return false;
+      }
+
+      std::shared_ptr<const Parser> published = std::move(parser);
+      current_.Store(published);
+      hash_ = hash;
+      reloads_.fetch_add(1, std::memory_order_relaxed);
+      SetError({});
+
+      // the parser is published either way, a throwing callback must not end the watcher thread
+      if (callback_) {
+        try {
+          callback_(published);
+        } catch (const std::exception& e) {
+          Fail(std::string("Callback failed: ") + e.what());
+        } catch (...) {
+          Fail("Callback failed");
+        }
+      }
+      return true;
+    }
+
+    void SetError(std::string error) {
+      std::lock_guard lock(error_mutex_);
+      last_error_ = std::move(error);
+    }
+
+    /// stores error for LastError and passes it to the error callback
+    void Fail(const std::string& error) {
+      SetError(error);
+      if (on_error_) {
+        try {
+          on_error_(error);
+        } catch (...) {
+        }
+      }
+    }
+
+#ifdef __linux__
+    void Start() {
+      inotify_ = ::inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+      stop_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+      // editors often replace the file instead of writing to it, so watch the directory for the name
+      const auto directory = file_.has_parent_path() ? file_.parent_path() : std::filesystem::path(".");
+      if (inotify_ == -1 || stop_ == -1 || ::inotify_add_watch(inotify_, directory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE) == -1) {
+        Close();
+        throw std::runtime_error("Failed to watch: " + file_.string());
+      }
+
+      thread_ = std::thread([this] {
+        Run();
+      });
+    }
+
+    void Stop() {
+      if (thread_.joinable()) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(stop_, &one, sizeof(one));
+        thread_.join();
+      }
+      Close();
+    }
+
+    void Close() {
+      if (inotify_ != -1) ::close(inotify_);
+      if (stop_ != -1) ::close(stop_);
+      inotify_ = -1;
+      stop_ = -1;
+    }
+
+    void Run() {
+      const auto name = file_.filename().string();
+      alignas(inotify_event) char buffer[4096];
+      bool pending = false;
+
+      while (true) {
+        pollfd fds[2] = {{inotify_, POLLIN, 0}, {stop_, POLLIN, 0}};
+        const int ready = ::poll(fds, 2, pending ? static_cast<int>(debounce_.count()) : -1);
+        if (ready == -1) {
+          if (errno == EINTR) continue;
+          return;
+        }
+
+        if (fds[1].revents & POLLIN) {
+          return;
+        }
+
+        if (ready == 0) {
+          // quiet for the whole debounce period, the burst is over
+          Reload();
+          pending = false;
+          continue;
+        }
+
+        ssize_t read;
+        while ((read = ::read(inotify_, buffer, sizeof(buffer))) > 0) {
+          for (ssize_t offset = 0; offset < read;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0 && name == event->name) {
+              pending = true;
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+          }
+        }
+      }
+    }
+#else
+    void Start() {
+      thread_ = std::thread([this] {
+        Run();
+      });
+    }
+
+    void Stop() {
+      if (thread_.joinable()) {
+        {
+          std::lock_guard lock(mutex_);
+          stop_ = true;
+        }
+        stop_cv_.notify_all();
+        thread_.join();
+      }
+    }
+
+    /// @return the modification time and size, compared to find out if the file changed
+    [[nodiscard]] std::pair<std::filesystem::file_time_type, std::uintmax_t> Stat() const {
+      std::error_code error;
+      const auto time = std::filesystem::last_write_time(file_, error);
+      const auto size = std::filesystem::file_size(file_, error);
+      return {time, error ? 0 : size};
+    }
+
+    void Run() {
+      // no change notifications, check the modification time every debounce period instead
+      auto last = Stat();
+      bool pending = false;
+
+      std::unique_lock lock(mutex_);
+      while (!stop_cv_.wait_for(lock, debounce_, [this] { return stop_; })) {
+        const auto now = Stat();
+        if (now != last) {
+          last = now;
+          pending = true;
+        } else if (pending) {
+          lock.unlock();
+          Reload();
+          lock.lock();
+          pending = false;
+        }
+      }
+    }
+#endif
+  };
+}
+
+#endif // INIREADER_WATCHER_HPP
@@ -0,0 +1,657 @@
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <benchmark/benchmark.h>
+#include "../include/inireader/inireader.hpp"
+#include "../include/inireader/schema.hpp"
+#include "../include/inireader/compiled.hpp"
+#include "../include/inireader/frozen.hpp"
+#include "../include/inireader/loader.hpp"
+#include "../include/inireader/overlay.hpp"
+
+namespace {
+  /// Which kind of values GenerateIni writes
+  enum class ValueKind {
+    Mixed,
+    String,
+    Integer,
+    Float,
+    Bool
+  };
+
+  /**
+   * @param sections amount of sections, the root section always gets keys_per_section items as well
+   * @param keys_per_section items in every section
+   * @param kind kind of the values, Mixed cycles through all of them
+   * @return a deterministic ini document, the same arguments always give the same bytes
+   */
+  std::string GenerateIni(const std::size_t sections, const std::size_t keys_per_section, const ValueKind kind = ValueKind::Mixed) {
+    std::uint32_t state = 0x12345678;
+    const auto next = [&state] {
+      state = state * 1664525u + 1013904223u;
+      return state >> 8;
+    };
+
+    const auto value = [&](const std::size_t i) -> std::string {
+      switch (kind == ValueKind::Mixed ? static_cast<ValueKind>(1 + i % 4) : kind) {
+        case ValueKind::Integer:
+          return std::to_string(static_cast<std::int32_t>(next()) - (1 << 23));
+        case ValueKind::Float:
+          return std::to_string(static_cast<double>(next()) / 1000.0);
+        case ValueKind::Bool:
+          return next() & 1 ? "true" : "off";
+        default:
+          return "\"value " + std::to_string(next()) + "\" ; comment";
+      }
+    };
+
+    std::string res;
+    for (std::size_t k = 0; k < keys_per_section; k++) {
+      res += "root_key_" + std::to_string(k) + " = " + value(k) + "\n";
+    }
+
+    for (std::size_t s = 0; s < sections; s++) {
+      res += "\n[section_" + std::to_string(s) + "]\n";
+      for (std::size_t k = 0; k < keys_per_section; k++) {
+        res += "key_" + std::to_string(k) + " = " + value(k) + "\n";
+      }
+    }
+    return res;
+  }
+
+  /// A generated document written to a temporary file for as long as it lives
+  struct TempIni {
+    TempIni(const std::size_t sections, const std::size_t keys_per_section) : contents(GenerateIni(sections, keys_per_section)) {
+      path = std::filesystem::temp_directory_path() / ("bench_inireader_" + std::to_string(sections) + "_" + std::to_string(keys_per_section) + ".ini");
+      std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+    }
+
+    ~TempIni() {
+      std::filesystem::remove(path);
+    }
+
+    std::string contents;
+    std::filesystem::path path;
+  };
+
+  void DocumentArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"sections", "keys"});
+    bench->Args({10, 10})->Args({1000, 10})->Args({10000, 20})->Args({100, 1000});
+  }
+
+  void ParseString(benchmark::State& state) {
+    const auto contents = GenerateIni(state.range(0), state.range(1));
+    for (auto _ : state) {
+      ini::Parser parser;
+      parser.Parse(contents, false);
+      benchmark::DoNotOptimize(parser.GetSectionCount());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * contents.size()));
+  }
+  BENCHMARK(ParseString)->Apply(DocumentArgs)->Unit(benchmark::kMicrosecond);
+
+  /// same as ParseString with the parser taking the contents, the copy handed to it is timed as well
+  void ParseOwnedString(benchmark::State& state) {
+    const auto contents = GenerateIni(state.range(0), state.range(1));
+    for (auto _ : state) {
+      ini::Parser parser;
+      parser.Parse(std::string(contents), false);
+      benchmark::DoNotOptimize(parser.GetSectionCount());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * contents.size()));
+  }
+  BENCHMARK(ParseOwnedString)->Apply(DocumentArgs)->Unit(benchmark::kMicrosecond);
+
+  /// same as ParseString while counting and timing every section and item
+  void ParseWithStats(benchmark::State& state) {
+    const auto contents = GenerateIni(state.range(0), state.range(1));
+    for (auto _ : state) {
+      ini::Parser parser;
+      benchmark::DoNotOptimize(parser.ParseWithStats(contents, false).keys);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * contents.size()));
+  }
+  BENCHMARK(ParseWithStats)->Apply(DocumentArgs)->Unit(benchmark::kMicrosecond);
+
+  /// tokenizing alone, the handler ignores every event
+  void Tokenize(benchmark::State& state) {
+    const auto contents = GenerateIni(state.range(0), state.range(1));
+    ini::StreamHandler handler;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(ini::ParseBuffer(contents, handler));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * contents.size()));
+  }
+  BENCHMARK(Tokenize)->Apply(DocumentArgs)->Unit(benchmark::kMicrosecond);
+
+  void ParsePath(benchmark::State& state) {
+    const TempIni ini(state.range(0), state.range(1));
+    for (auto _ : state) {
+      ini::Parser parser;
+      parser.Parse(ini.path);
+      benchmark::DoNotOptimize(parser.GetSectionCount());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * ini.contents.size()));
+  }
+  BENCHMARK(ParsePath)->Apply(DocumentArgs)->Unit(benchmark::kMicrosecond);
+
+  void ParseStream(benchmark::State& state) {
+    const TempIni ini(state.range(0), state.range(1));
+    for (auto _ : state) {
+      ini::Parser parser;
+      std::ifstream file(ini.path);
+      parser.Parse(file);
+      benchmark::DoNotOptimize(parser.GetSectionCount());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * ini.contents.size()));
+  }
+  BENCHMARK(ParseStream)->Apply(DocumentArgs)->Unit(benchmark::kMicrosecond);
+
+  /// A conf.d style directory of generated fragments, removed when it dies
+  struct TempDirectory {
+    TempDirectory(const std::size_t files, const std::size_t sections, const std::size_t keys_per_section) {
+      path = std::filesystem::temp_directory_path() / ("bench_inireader_" + std::to_string(files) + ".d");
+      std::filesystem::create_directories(path);
+      const auto contents = GenerateIni(sections, keys_per_section);
+      for (std::size_t i = 0; i < files; i++) {
+        std::ofstream(path / ("fragment_" + std::to_string(i) + ".ini"), std::ios::binary | std::ios::trunc) << contents;
+      }
+      bytes = files * contents.size();
+    }
+
+    ~TempDirectory() {
+      std::filesystem::remove_all(path);
+    }
+
+    std::filesystem::path path;
+    std::size_t bytes = 0;
+  };
+
+  /// 300 small fragments parsed one after the other, what LoadDirectory replaces
+  void ParseFragments(benchmark::State& state) {
+    const TempDirectory directory(300, 5, 10);
+    for (auto _ : state) {
+      std::vector<std::filesystem::path> paths;
+      for (const auto& entry : std::filesystem::directory_iterator(directory.path)) {
+        paths.push_back(entry.path());
+      }
+      std::sort(paths.begin(), paths.end());
+
+      std::vector<std::unique_ptr<ini::Parser>> parsers;
+      for (const auto& path : paths) {
+        parsers.push_back(std::make_unique<ini::Parser>());
+        parsers.back()->Parse(path);
+      }
+      benchmark::DoNotOptimize(parsers.size());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * directory.bytes));
+  }
+  BENCHMARK(ParseFragments)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+  void LoadDirectory(benchmark::State& state) {
+    const TempDirectory directory(300, 5, 10);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(ini::LoadDirectory(directory.path, ".ini", static_cast<unsigned>(state.range(0))).size());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * directory.bytes));
+  }
+  BENCHMARK(LoadDirectory)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+  /// startup with an up to date image, maps it and reads one value
+  void LoadCompiled(benchmark::State& state) {
+    const TempIni ini(state.range(0), state.range(1));
+    auto image = ini.path;
+    image.replace_extension(".inic");
+    ini::CompiledDocument::Load(ini.path, image);
+
+    for (auto _ : state) {
+      const auto document = ini::CompiledDocument::Load(ini.path, image);
+      benchmark::DoNotOptimize(document.GetRootSection()["root_key_1"].as<std::int32_t>());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * ini.contents.size()));
+    std::filesystem::remove(image);
+  }
+  BENCHMARK(LoadCompiled)->Apply(DocumentArgs)->Unit(benchmark::kMicrosecond);
+
+  /// names of every section and key of a document made by GenerateIni
+  struct Names {
+    Names(const std::size_t sections, const std::size_t keys_per_section) {
+      for (std::size_t s = 0; s < sections; s++) {
+        this->sections.push_back("section_" + std::to_string(s));
+        missing_sections.push_back("missing_" + std::to_string(s));
+      }
+      for (std::size_t k = 0; k < keys_per_section; k++) {
+        keys.push_back("key_" + std::to_string(k));
+        missing_keys.push_back("missing_" + std::to_string(k));
+      }
+    }
+
+    std::vector<std::string> sections;
+    std::vector<std::string> missing_sections;
+    std::vector<std::string> keys;
+    std::vector<std::string> missing_keys;
+  };
+
+  void LookupArgs(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"sections", "keys"});
+    bench->Args({10, 10})->Args({10000, 20});
+  }
+
+  void GetSectionHit(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const Names names(state.range(0), state.range(1));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(&parser.GetSection(names.sections[i++ % names.sections.size()]));
+    }
+  }
+  BENCHMARK(GetSectionHit)->Apply(LookupArgs);
+
+  /// a key of the lowest of three layers, the two above have the same sections with other keys. range(2) turns on memoization
+  void OverlayIndexHit(benchmark::State& state) {
+    const auto layer = [](const std::string& contents) {
+      auto parser = std::make_shared<ini::Parser>();
+      parser->Parse(contents, false);
+      return std::shared_ptr<const ini::Parser>(std::move(parser));
+    };
+    const auto defaults = GenerateIni(state.range(0), state.range(1));
+    std::string overrides;
+    for (std::int64_t s = 0; s < state.range(0); s++) {
+      overrides += "[section_" + std::to_string(s) + "]\noverride = 1\n";
+    }
+    const ini::Overlay overlay({layer(defaults), layer(overrides), layer(overrides)}, state.range(2) != 0);
+    const Names names(state.range(0), state.range(1));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+      const auto& section = names.sections[i % names.sections.size()];
+      benchmark::DoNotOptimize(&overlay[section][names.keys[i++ % names.keys.size()]]);
+    }
+  }
+  BENCHMARK(OverlayIndexHit)->ArgNames({"sections", "keys", "memoize"})->Args({10, 10, 0})->Args({10, 10, 1})->Args({10000, 20, 0})->Args({10000, 20, 1});
+
+  void GetSectionMiss(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const Names names(state.range(0), state.range(1));
+
+    // GetSection throws on a miss, HasSection is the non throwing way to look
+    std::size_t i = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(parser.HasSection(names.missing_sections[i++ % names.missing_sections.size()]));
+    }
+  }
+  BENCHMARK(GetSectionMiss)->Apply(LookupArgs);
+
+  void OperatorIndexHit(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const Names names(state.range(0), state.range(1));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+      auto& section = parser[names.sections[i % names.sections.size()]];
+      benchmark::DoNotOptimize(&section[names.keys[i % names.keys.size()]]);
+      i++;
+    }
+  }
+  BENCHMARK(OperatorIndexHit)->Apply(LookupArgs);
+
+  /// same lookups with names interned once up front, no string is hashed or compared
+  void OperatorIndexSymbolHit(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const Names names(state.range(0), state.range(1));
+    std::vector<ini::Symbol> sections;
+    std::vector<ini::Symbol> keys;
+    for (const auto& name : names.sections) sections.push_back(parser.Intern(name));
+    for (const auto& key : names.keys) keys.push_back(parser.Intern(key));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+      auto& section = parser[sections[i % sections.size()]];
+      benchmark::DoNotOptimize(&section[keys[i % keys.size()]]);
+      i++;
+    }
+  }
+  BENCHMARK(OperatorIndexSymbolHit)->Apply(LookupArgs);
+
+  void OperatorIndexMiss(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const Names names(state.range(0), state.range(1));
+
+    // operator[] throws on a miss, HasValue is the non throwing way to look
+    std::size_t i = 0;
+    for (auto _ : state) {
+      auto& section = parser[names.sections[i % names.sections.size()]];
+      benchmark::DoNotOptimize(section.HasValue(names.missing_keys[i % names.missing_keys.size()]));
+      i++;
+    }
+  }
+  BENCHMARK(OperatorIndexMiss)->Apply(LookupArgs);
+
+  /// eight settings of mixed types from a different section every time, GenerateIni cycles string, integer, float, bool
+  void SeparateAs(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const Names names(state.range(0), state.range(1));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+      const auto& section = parser[names.sections[i++ % names.sections.size()]];
+      benchmark::DoNotOptimize(section["key_0"].as<std::string_view>());
+      benchmark::DoNotOptimize(section["key_1"].as<std::int32_t>());
+      benchmark::DoNotOptimize(section["key_2"].as<double>());
+      benchmark::DoNotOptimize(section["key_3"].as<bool>());
+      benchmark::DoNotOptimize(section["key_4"].as<std::string_view>());
+      benchmark::DoNotOptimize(section["key_5"].as<std::int32_t>());
+      benchmark::DoNotOptimize(section["key_6"].as<double>());
+      benchmark::DoNotOptimize(section["key_7"].as<bool>());
+    }
+  }
+  BENCHMARK(SeparateAs)->Apply(LookupArgs);
+
+  void GetMany(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const Names names(state.range(0), state.range(1));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+      const auto& section = parser[names.sections[i++ % names.sections.size()]];
+      const auto [a, b, c, d, e, f, g, h] = section.GetMany<std::string_view, std::int32_t, double, bool, std::string_view, std::int32_t, double, bool>(
+          "key_0", "key_1", "key_2", "key_3", "key_4", "key_5", "key_6", "key_7");
+      benchmark::DoNotOptimize(*a);
+      benchmark::DoNotOptimize(*b);
+      benchmark::DoNotOptimize(*c);
+      benchmark::DoNotOptimize(*d);
+      benchmark::DoNotOptimize(*e);
+      benchmark::DoNotOptimize(*f);
+      benchmark::DoNotOptimize(*g);
+      benchmark::DoNotOptimize(*h);
+    }
+  }
+  BENCHMARK(GetMany)->Apply(LookupArgs);
+
+  void FrozenGetSectionHit(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const ini::FrozenDocument frozen(parser);
+    const Names names(state.range(0), state.range(1));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(&frozen.GetSection(names.sections[i++ % names.sections.size()]));
+    }
+  }
+  BENCHMARK(FrozenGetSectionHit)->Apply(LookupArgs);
+
+  void FrozenGetSectionMiss(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const ini::FrozenDocument frozen(parser);
+    const Names names(state.range(0), state.range(1));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(frozen.HasSection(names.missing_sections[i++ % names.missing_sections.size()]));
+    }
+  }
+  BENCHMARK(FrozenGetSectionMiss)->Apply(LookupArgs);
+
+  void FrozenOperatorIndexHit(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const ini::FrozenDocument frozen(parser);
+    const Names names(state.range(0), state.range(1));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+      const auto& section = frozen[names.sections[i % names.sections.size()]];
+      benchmark::DoNotOptimize(&section[names.keys[i % names.keys.size()]]);
+      i++;
+    }
+  }
+  BENCHMARK(FrozenOperatorIndexHit)->Apply(LookupArgs);
+
+  void Freeze(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+
+    for (auto _ : state) {
+      const ini::FrozenDocument frozen(parser);
+      benchmark::DoNotOptimize(frozen.GetSectionCount());
+    }
+  }
+  BENCHMARK(Freeze)->Apply(LookupArgs)->Unit(benchmark::kMicrosecond);
+
+  /// shared by the threads of the concurrent read benchmarks
+  ini::Parser g_shared;
+  std::mutex g_shared_mutex;
+
+  void SharedSetup(const benchmark::State& /*state*/) {
+    g_shared.Parse(GenerateIni(1000, 10), false);
+    g_shared.Publish();
+  }
+
+  void SnapshotRead(benchmark::State& state) {
+    const Names names(1000, 10);
+    std::size_t i = static_cast<std::size_t>(state.thread_index()) * 7919;
+    for (auto _ : state) {
+      const auto snapshot = g_shared.GetSnapshot();
+      benchmark::DoNotOptimize(snapshot[names.sections[i % names.sections.size()]][names.keys[i % names.keys.size()]].as<std::string_view>());
+      i++;
+    }
+  }
+  BENCHMARK(SnapshotRead)->Setup(SharedSetup)->ThreadRange(1, 16)->UseRealTime();
+
+  void MutexRead(benchmark::State& state) {
+    const Names names(1000, 10);
+    std::size_t i = static_cast<std::size_t>(state.thread_index()) * 7919;
+    for (auto _ : state) {
+      std::lock_guard lock(g_shared_mutex);
+      benchmark::DoNotOptimize(g_shared[names.sections[i % names.sections.size()]][names.keys[i % names.keys.size()]].as<std::string_view>());
+      i++;
+    }
+  }
+  BENCHMARK(MutexRead)->Setup(SharedSetup)->ThreadRange(1, 16)->UseRealTime();
+
+  /**
+   * @tparam T type to convert to
+   * @param text value stored in the section
+   * @note as<T> caches numeric conversions, so this measures the cached path
+   */
+  template <typename T>
+  void As(benchmark::State& state, const char* text) {
+    ini::Parser parser;
+    parser.GetRootSection().Add("value", text);
+    auto& value = parser.GetRootSection()["value"];
+
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(value.as<T>());
+    }
+  }
+
+  /**
+   * @tparam T type to convert to
+   * @param text value to convert
+   * @note the conversion itself, without the cache of IniValue
+   */
+  template <typename T>
+  void Convert(benchmark::State& state, const char* text) {
+    const std::string_view value = text;
+    for (auto _ : state) {
+      T res{};
+      if (ini::conversion::AsImpl<T>::is(value)) {
+        ini::conversion::AsImpl<T>::get(value, res);
+      }
+      benchmark::DoNotOptimize(res);
+    }
+  }
+
+  /**
+   * @tparam T type to convert to
+   * @param type name of T in the benchmark name
+   * @param text value to convert
+   */
+  template <typename T>
+  void RegisterConversion(const std::string& type, const char* text) {
+    benchmark::RegisterBenchmark(("As<" + type + ">").c_str(), As<T>, text);
+    benchmark::RegisterBenchmark(("Convert<" + type + ">").c_str(), Convert<T>, text);
+  }
+
+  void RegisterConversions() {
+#define INIREADER_BENCH_AS(type, text) RegisterConversion<type>(#type, text)
+    INIREADER_BENCH_AS(bool, "on");
+    INIREADER_BENCH_AS(std::int8_t, "-100");
+    INIREADER_BENCH_AS(std::uint8_t, "200");
+    INIREADER_BENCH_AS(std::int16_t, "-30000");
+    INIREADER_BENCH_AS(std::uint16_t, "0xffee");
+    INIREADER_BENCH_AS(std::int32_t, "-1285");
+    INIREADER_BENCH_AS(std::uint32_t, "01754");
+    INIREADER_BENCH_AS(std::int64_t, "-9223372036854775807");
+    INIREADER_BENCH_AS(std::uint64_t, "1122334400000000");
+    INIREADER_BENCH_AS(float, "3.14159");
+    INIREADER_BENCH_AS(double, "-124.45667356");
+    INIREADER_BENCH_AS(std::string, "a value longer than the small string buffer");
+    INIREADER_BENCH_AS(std::string_view, "a value longer than the small string buffer");
+    INIREADER_BENCH_AS(std::u16string, "hello, world");
+    INIREADER_BENCH_AS(std::u32string, "hello, world");
+    INIREADER_BENCH_AS(const char*, "value");
+    INIREADER_BENCH_AS(char*, "value");
+#undef INIREADER_BENCH_AS
+  }
+
+  void Stringify(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+      const auto res = parser.Stringify();
+      bytes += res.size();
+      benchmark::DoNotOptimize(res.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+  }
+  BENCHMARK(Stringify)->Apply(DocumentArgs)->Unit(benchmark::kMicrosecond);
+
+  void Save(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const auto path = std::filesystem::temp_directory_path() / "bench_inireader_save.ini";
+
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(parser.Save(path));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(path)));
+    std::filesystem::remove(path);
+  }
+  BENCHMARK(Save)->Apply(DocumentArgs)->Unit(benchmark::kMicrosecond);
+
+  /// a control plane publishing counters, every value is overwritten with a number and read back once
+  void AssignCounters(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const Names names(state.range(0), state.range(1));
+
+    std::int64_t counter = 0;
+    for (auto _ : state) {
+      for (const auto& section : names.sections) {
+        auto& values = parser[section];
+        for (const auto& key : names.keys) {
+          values[key] = counter++;
+          benchmark::DoNotOptimize(values[key].as<std::int64_t>());
+        }
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+  }
+  BENCHMARK(AssignCounters)->Args({10, 10})->Args({1000, 10})->Unit(benchmark::kMicrosecond);
+
+  /// AssignCounters followed by the periodic Save
+  void AssignCountersAndSave(benchmark::State& state) {
+    ini::Parser parser;
+    parser.Parse(GenerateIni(state.range(0), state.range(1)), false);
+    const Names names(state.range(0), state.range(1));
+    const auto path = std::filesystem::temp_directory_path() / "bench_inireader_counters.ini";
+
+    double value = 0.5;
+    for (auto _ : state) {
+      for (const auto& section : names.sections) {
+        auto& values = parser[section];
+        for (const auto& key : names.keys) {
+          values[key] = value;
+          value += 1.25;
+        }
+      }
+      benchmark::DoNotOptimize(parser.Save(path));
+    }
+    std::filesystem::remove(path);
+  }
+  BENCHMARK(AssignCountersAndSave)->Args({10, 10})->Args({1000, 10})->Unit(benchmark::kMicrosecond);
+
+  /// The kind of struct a program reads its configuration into, GenerateIni cycles string, integer, float, bool
+  struct BenchConfig {
+    std::string name;
+    std::int32_t count = 0;
+    double ratio = 0;
+    bool enabled = false;
+    std::int32_t root = 0;
+  };
+
+  void SchemaBind(benchmark::State& state) {
+    const auto contents = GenerateIni(state.range(0), state.range(1));
+    const auto schema = ini::MakeSchema(
+        ini::MakeField("section_5", "key_0", &BenchConfig::name),
+        ini::MakeField("section_5", "key_1", &BenchConfig::count),
+        ini::MakeField("section_5", "key_2", &BenchConfig::ratio),
+        ini::MakeField("section_5", "key_3", &BenchConfig::enabled),
+        ini::MakeField("", "root_key_1", &BenchConfig::root));
+
+    for (auto _ : state) {
+      BenchConfig config;
+      const auto errors = schema.Bind(std::string_view(contents), config);
+      benchmark::DoNotOptimize(errors.data());
+      benchmark::DoNotOptimize(config);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * contents.size()));
+  }
+  BENCHMARK(SchemaBind)->Args({10, 10})->Args({100, 10})->Unit(benchmark::kMicrosecond);
+
+  /// what SchemaBind replaces, a full Parser followed by a lookup for every field
+  void ParseAndLookup(benchmark::State& state) {
+    const auto contents = GenerateIni(state.range(0), state.range(1));
+
+    for (auto _ : state) {
+      ini::Parser parser;
+      parser.Parse(contents, false);
+      BenchConfig config;
+      config.name = parser["section_5"]["key_0"].as<std::string>();
+      config.count = parser["section_5"]["key_1"].as<std::int32_t>();
+      config.ratio = parser["section_5"]["key_2"].as<double>();
+      config.enabled = parser["section_5"]["key_3"].as<bool>();
+      config.root = parser.GetRootSection()["root_key_1"].as<std::int32_t>();
+      benchmark::DoNotOptimize(config);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * contents.size()));
+  }
+  BENCHMARK(ParseAndLookup)->Args({10, 10})->Args({100, 10})->Unit(benchmark::kMicrosecond);
+}
+
+int main(int argc, char** argv) {
+  RegisterConversions();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
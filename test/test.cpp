@@ -4,11 +4,73 @@
 #ifndef NDEBUG
 #define NDEBUG
 #include "../include/inireader/inireader.hpp"
+#include "../include/inireader/document.hpp"
+#include "../include/inireader/editor.hpp"
+#include "../include/inireader/watcher.hpp"
+#include "../include/inireader/schema.hpp"
+#include "../include/inireader/compiled.hpp"
+#include "../include/inireader/frozen.hpp"
+#include "../include/inireader/loader.hpp"
+#include "../include/inireader/overlay.hpp"
 #undef NDEBUG
 #else
 #include "../include/inireader/inireader.hpp"
+#include "../include/inireader/document.hpp"
+#include "../include/inireader/editor.hpp"
+#include "../include/inireader/watcher.hpp"
+#include "../include/inireader/schema.hpp"
+#include "../include/inireader/compiled.hpp"
+#include "../include/inireader/frozen.hpp"
+#include "../include/inireader/loader.hpp"
+#include "../include/inireader/overlay.hpp"
 #endif
 
+// counts every heap allocation so tests can check that a path doesn't allocate
+inline std::size_t g_allocations{};
+
+// inlined into their callers GCC pairs the malloc and free below with new and delete and warns with -Wmismatched-new-delete
+#if defined(__GNUC__)
+#define TEST_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define TEST_NOINLINE __declspec(noinline)
+#else
+#define TEST_NOINLINE
+#endif
+
+TEST_NOINLINE void* operator new(std::size_t size) {
+  g_allocations++;
+  if (void* ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+TEST_NOINLINE void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+TEST_NOINLINE void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+// counts the allocations of the parsers it is passed to, the default resource allocates with a operator new that isn't counted above
+struct CountingResource : std::pmr::memory_resource {
+  std::size_t allocations = 0;
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    allocations++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
 struct TestCtx;
 inline TestCtx* g_testctx{};
 
@@ -71,6 +133,282 @@ TEST(Parse, Other) {
   EXPECT_EQ(section["bool3"].as<bool>(), false);
 }
 
+TEST(Parse, Tokenizer) {
+  ini::Parser parser;
+  parser.Parse("key\t =\t\"quoted value\"\r\n"
+               "a;b = c\n"
+               "   ; indented comment\n"
+               "[esc\\]aped] ; comment\n"
+               "x=\"\"\n"
+               "y = 1 # comment\n"
+               "[unterminated\n"
+               "z = 2", false);
+
+  EXPECT_EQ(parser.GetRootSection()["key"].as<std::string>(), "quoted value");
+  EXPECT_EQ(parser.GetRootSection()["a;b"].as<std::string>(), "c");
+  EXPECT_EQ(parser.GetRootSection().Size(), 2);
+  EXPECT_EQ(parser["esc\\]aped"]["y"].as<std::string>(), "1");
+  EXPECT_FALSE(parser["esc\\]aped"].HasValue("x"));
+  EXPECT_EQ(parser["unterminated"]["z"].as<int>(), 2);
+
+  auto token = ini::tokenizer::ScanLine("  [not a section]");
+  EXPECT_EQ(token.type, ini::tokenizer::TokenType::Empty);
+  token = ini::tokenizer::ScanLine("k = v;v");
+  EXPECT_EQ(token.type, ini::tokenizer::TokenType::Item);
+  EXPECT_EQ(token.value, "v;v");
+}
+
+TEST(Parse, SimdMatchesScalar) {
+  using ini::tokenizer::Delimiters;
+  using ini::simd::Level;
+
+  // the plain byte by byte split the vectorized one has to match exactly
+  const auto reference = [](const std::string_view buffer) {
+    std::vector<std::pair<std::string_view, Delimiters>> lines;
+    std::size_t start = 0;
+    for (std::size_t i = 0; i <= buffer.size(); i++) {
+      if (i == buffer.size() ? start < buffer.size() : buffer[i] == '\n' || buffer[i] == '\r') {
+        const auto line = buffer.substr(start, i - start);
+        lines.emplace_back(line, ini::tokenizer::FindDelimiters(line));
+        start = i + 1;
+      }
+    }
+    return lines;
+  };
+  const auto same = [](const ini::tokenizer::Token& a, const ini::tokenizer::Token& b) {
+    return a.type == b.type && a.key.data() == b.key.data() && a.key.size() == b.key.size() && a.value.data() == b.value.data() &&
+           a.value.size() == b.value.size() && a.comment.data() == b.comment.data() && a.comment.size() == b.comment.size();
+  };
+
+  std::vector<std::string> buffers = {"", "\n", "a", "[s]", std::string(64, '\n'), std::string(64, '='), std::string(200, 'x'), std::string(127, ';') + "\r"};
+  std::uint32_t state = 42;
+  const std::string_view alphabet = "\n\r;#=[]\" abcx\0\x80\xff";
+  for (const std::size_t size : {1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 1000, 4096}) {
+    for (int i = 0; i < 20; i++) {
+      std::string buffer(size, ' ');
+      for (auto& c : buffer) {
+        state = state * 1664525u + 1013904223u;
+        c = alphabet[(state >> 16) % alphabet.size()];
+      }
+      buffers.push_back(std::move(buffer));
+    }
+  }
+  {
+    std::ifstream ifs("test.ini", std::ios::binary);
+    buffers.emplace_back(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  }
+
+  for (const auto level : {Level::Scalar, Level::SSE2, Level::AVX2}) {
+    if (!ini::simd::Supported(level)) continue;
+
+    for (const auto& buffer : buffers) {
+      const auto expected = reference(buffer);
+      std::size_t i = 0;
+      bool matches = true;
+      ini::tokenizer::ScanLines(buffer, [&](const std::string_view line, const Delimiters& delimiters) {
+        matches = matches && i < expected.size() && line.data() == expected[i].first.data() && line.size() == expected[i].first.size() &&
+                  delimiters.semicolon == expected[i].second.semicolon && delimiters.hash == expected[i].second.hash && delimiters.eq == expected[i].second.eq &&
+                  same(ini::tokenizer::ScanLine(line, delimiters), ini::tokenizer::ScanLine(line));
+        i++;
+        return true;
+      }, nullptr, level);
+      EXPECT_TRUE(matches && i == expected.size()) << "level " << static_cast<int>(level) << " size " << buffer.size();
+
+      // with a tail the last line without a line break is left out
+      std::size_t tail = 0;
+      i = 0;
+      ini::tokenizer::ScanLines(buffer, [&](const std::string_view, const Delimiters&) {
+        i++;
+        return true;
+      }, &tail, level);
+      const bool has_tail = !buffer.empty() && buffer.back() != '\n' && buffer.back() != '\r';
+      EXPECT_EQ(i, expected.size() - has_tail);
+      EXPECT_EQ(tail, has_tail ? static_cast<std::size_t>(expected.back().first.data() - buffer.data()) : buffer.size());
+    }
+  }
+}
+
+TEST(Parse, MemoryResource) {
+  CountingResource counting;
+
+  // nothing below the root may fall back to the default resource
+  auto* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  {
+    ini::Parser parser(true, &counting);
+    parser.Parse("a key longer than the small string buffer = a value longer than the small string buffer\n"
+                 "[a section name longer than the small string buffer]\n"
+                 "key = value\n", false);
+    parser.AddSection("added").Add("added key longer than the small string buffer", 1234);
+    parser["added"]["added key longer than the small string buffer"] = "another value longer than the small string buffer";
+
+    EXPECT_GT(counting.allocations, 0);
+    EXPECT_EQ(parser.GetRootSection()["a key longer than the small string buffer"].as<std::string>(), "a value longer than the small string buffer");
+    EXPECT_EQ(parser["a section name longer than the small string buffer"]["key"].as<std::string>(), "value");
+  }
+  std::pmr::set_default_resource(previous);
+}
+
+TEST(Parse, Stats) {
+  const std::string contents = "root = 1\r\n"
+                               "; a comment\n"
+                               "[a]\n"
+                               "key = 1 # trailing\n"
+                               "key = 2\n"
+                               "\n"
+                               "[b]\n"
+                               "other = 3\n"
+                               "[a]\n"
+                               "last = 4";
+
+  ini::Parser parser;
+  const auto stats = parser.ParseWithStats(contents, false);
+  EXPECT_EQ(stats.bytes, contents.size());
+  EXPECT_EQ(stats.lines, 10);
+  EXPECT_EQ(stats.sections, 3);
+  EXPECT_EQ(stats.keys, 5);
+  EXPECT_EQ(stats.duplicate_sections, 1);
+  EXPECT_EQ(stats.duplicate_keys, 1);
+  EXPECT_EQ(stats.comments, 2);
+  EXPECT_GT(stats.allocations, 0);
+  EXPECT_EQ(stats.read.count(), 0);
+  EXPECT_EQ(parser["a"]["last"].as<int>(), 4);
+  EXPECT_FALSE(parser["a"].HasValue("key"));
+
+  // the hook sees every parse, the document is the same as without it
+  std::vector<ini::ParseStats> seen;
+  parser.SetParseHook([&seen](const ini::ParseStats& parse) {
+    seen.push_back(parse);
+  });
+  parser.Parse(contents, false);
+  parser.Parse(std::filesystem::path("test.ini"));
+  ASSERT_EQ(seen.size(), 2);
+  EXPECT_EQ(seen[0].keys, stats.keys);
+  EXPECT_EQ(seen[1].bytes, std::filesystem::file_size("test.ini"));
+  EXPECT_TRUE(parser.HasSection("Section 1"));
+
+  parser.SetParseHook({});
+  parser.Parse(contents, false);
+  EXPECT_EQ(seen.size(), 2);
+}
+
+TEST(Parse, Symbols) {
+  ini::Parser parser;
+  parser.Parse("[a]\nport = 1\nhost = x\n[b]\nport = 2\n", false);
+
+  // a key used by every section is stored once
+  const auto port = parser.Intern("port");
+  EXPECT_EQ(parser.Intern("port"), port);
+  EXPECT_EQ(port, "port");
+  EXPECT_EQ(parser["a"][port].as<int>(), 1);
+  EXPECT_EQ(parser["b"][port].as<int>(), 2);
+  EXPECT_EQ(parser[parser.Intern("b")]["port"].as<int>(), 2);
+  EXPECT_FALSE(parser["b"].HasValue(parser.Intern("host")));
+  for (auto it = parser["b"].begin(); it != parser["b"].end(); ++it) {
+    EXPECT_EQ(it->first.data(), port.data());
+  }
+
+  parser["b"].Add(parser.Intern("weight"), 3);
+  EXPECT_EQ(parser["b"]["weight"].as<int>(), 3);
+  EXPECT_FALSE(parser.HasSection(ini::Symbol()));
+
+  // symbols of another parser are never equal, lookups with them fall back to the string
+  ini::Parser other;
+  other.Parse("[b]\nweight = 4\nport = 5\n", false);
+  EXPECT_NE(other.Intern("port"), port);
+  EXPECT_EQ(other["b"][port].as<int>(), 5);
+  EXPECT_EQ(parser["b"][other.Intern("weight")].as<int>(), 3);
+  parser["b"].Merge(std::move(other["b"]));
+  EXPECT_EQ(parser["b"][port].as<int>(), 5);
+
+  // a snapshot keeps reading while the parser interns new names
+  parser.Publish();
+  const auto snapshot = parser.GetSnapshot();
+  for (int i = 0; i < 1000; i++) {
+    parser.AddSection("added " + std::to_string(i)).Add("key " + std::to_string(i), i);
+  }
+  EXPECT_TRUE(snapshot.SectionHasValue("a", "host"));
+  EXPECT_FALSE(snapshot.HasSection("added 1"));
+  EXPECT_EQ(parser["added 999"]["key 999"].as<int>(), 999);
+}
+
+TEST(Parse, OwnedBuffer) {
+  std::string contents;
+  for (int i = 0; i < 100; i++) {
+    contents += "[section " + std::to_string(i) + "]\n";
+    for (int j = 0; j < 8; j++) {
+      contents += "key " + std::to_string(j) + " = a value that does not fit in a small string " + std::to_string(i) + " ; comment\n";
+    }
+  }
+  const std::size_t sections = 100;
+  const std::size_t keys = sections * 8;
+
+  CountingResource counting;
+  ini::Parser parser(true, &counting);
+  parser.Parse(std::string(contents), false);
+
+  // names are interned by the first parse, values point into the buffer instead of being copied.
+  // a item costs at most its map entry, a section its entry and the table of its items, and the sections map grows a few times
+  std::string owned = contents;
+  auto before = counting.allocations + g_allocations;
+  parser.Parse(std::move(owned), false);
+  const auto allocations = counting.allocations + g_allocations - before;
+  EXPECT_LE(allocations, keys + 2 * sections + 16);
+
+  // copying costs a allocation per value, taking the buffer one for all of them
+  before = counting.allocations + g_allocations;
+  parser.Parse(contents, false);
+  EXPECT_GE(counting.allocations + g_allocations - before, allocations + keys - 1);
+
+  EXPECT_STREQ(parser["section 42"]["key 7"].as<const char*>(), "a value that does not fit in a small string 42");
+  EXPECT_EQ(parser.Stringify(), [&contents] {
+    ini::Parser copied;
+    copied.Parse(contents, false);
+    return copied.Stringify();
+  }());
+
+  // values and copies of them keep the buffer alive, assigning drops it
+  const auto value = parser["section 1"]["key 1"];
+  parser["section 1"]["key 1"] = 5;
+  parser.Parse(std::string("other = 1\n"), false);
+  EXPECT_EQ(value.as<std::string>(), "a value that does not fit in a small string 1");
+  EXPECT_EQ(parser.GetRootSection()["other"].as<int>(), 1);
+
+  const auto stats = parser.ParseWithStats(std::string("a = 1\r\nb = 2\r\n"), false);
+  EXPECT_EQ(stats.lines, 2);
+  EXPECT_EQ(parser.GetRootSection()["a"].as<int>(), 1);
+
+  // rvalues are moved in
+  auto& root = parser.GetRootSection();
+  root["a"] = "a value that does not fit in a small string";
+  const auto before_add = counting.allocations;
+  root.Add("b", std::move(root["a"]));
+  EXPECT_EQ(counting.allocations, before_add);
+  EXPECT_EQ(root["b"].as<std::string>(), "a value that does not fit in a small string");
+  root.Emplace("emplaced") = 3;
+  EXPECT_EQ(root["emplaced"].as<int>(), 3);
+}
+
+TEST(Parse, Move) {
+  static_assert(std::is_move_constructible_v<ini::Parser> && std::is_move_assignable_v<ini::Parser>);
+
+  std::vector<ini::Parser> parsers;
+  {
+    ini::Parser parser;
+    parser.Parse("[a]\nkey = 1\n", false);
+    parser.Publish();
+    parsers.push_back(std::move(parser));
+  }
+  parsers.emplace_back().Parse("[b]\nkey = 2\n", false);
+
+  EXPECT_EQ(parsers[0]["a"]["key"].as<int>(), 1);
+  EXPECT_EQ(parsers[0].GetSnapshot()["a"]["key"].as<int>(), 1);
+  parsers[0] = std::move(parsers[1]);
+  EXPECT_EQ(parsers[0]["b"]["key"].as<int>(), 2);
+  EXPECT_FALSE(parsers[0].HasSection("a"));
+  parsers[0].AddSection("added").Add("key", 3);
+  EXPECT_EQ(parsers[0]["added"]["key"].as<int>(), 3);
+}
+
 TEST(Add, Default) {
   g_testctx->ini_file.GetRootSection().Add("testv", "hi");
   EXPECT_STREQ(g_testctx->ini_file.GetRootSection()["testv"].as<const char*>(), "hi");
@@ -118,6 +456,23 @@ TEST(Has, Kv) {
   EXPECT_EQ(g_testctx->ini_file.SectionHasValue("Section 1", "Option 1"), true);
 }
 
+TEST(Has, NoAllocation) {
+  ini::Parser parser;
+  parser.Parse("[a section name that does not fit in a small string]\n"
+               "a key that does not fit in a small string either = value\n", false);
+
+  constexpr std::string_view section = "a section name that does not fit in a small string";
+  constexpr std::string_view key = "a key that does not fit in a small string either";
+
+  const auto before = g_allocations;
+  EXPECT_TRUE(parser.HasSection(section));
+  EXPECT_TRUE(parser.SectionHasValue(section, key));
+  EXPECT_TRUE(parser.GetSection(section).HasValue(key));
+  EXPECT_EQ(parser[section][key].as<std::string_view>(), "value");
+  EXPECT_FALSE(parser.HasSection("a missing section name that does not fit in a small string"));
+  EXPECT_EQ(g_allocations, before);
+}
+
 TEST(Edit, Default) {
   g_testctx->ini_file.GetRootSection().Add("edittest", 4);
   EXPECT_EQ(g_testctx->ini_file.GetRootSection().HasValue("edittest"), true);
@@ -149,6 +504,141 @@ TEST(Edit, Reference) {
   EXPECT_FALSE(g_testctx->ini_file["edit_ref"].HasValue("test_num"));
 }
 
+TEST(Edit, CachedValue) {
+  ini::Parser::IniSection& section = g_testctx->ini_file.AddSection("cache");
+  section.Add("num", 42);
+
+  EXPECT_EQ(section["num"].as<std::int32_t>(), 42);
+  EXPECT_EQ(section["num"].as<std::int32_t>(), 42);
+  EXPECT_TRUE(section["num"].is<std::int32_t>());
+  EXPECT_EQ(section["num"].as<double>(), 42.0);
+
+  ini::Parser::IniValue copy = section["num"];
+  EXPECT_EQ(copy.as<std::int32_t>(), 42);
+
+  section["num"] = "1337";
+  EXPECT_EQ(section["num"].as<std::int32_t>(), 1337);
+  section["num"] = "not a number";
+  EXPECT_FALSE(section["num"].is<std::int32_t>());
+  EXPECT_EQ(copy.as<std::int32_t>(), 42);
+
+  EXPECT_TRUE(g_testctx->ini_file.RemoveSection("cache"));
+}
+
+TEST(Edit, NativeValue) {
+  ini::Parser parser;
+  auto& section = parser.AddSection("native");
+  section.Add("int", -42);
+  section.Add("float", 0.1);
+  section.Add("flag", true);
+  section.Add("big", std::numeric_limits<std::uint64_t>::max());
+
+  // read back as the assigned type without parsing, as another type through the text
+  EXPECT_EQ(section["int"].as<std::int32_t>(), -42);
+  EXPECT_EQ(section["int"].as<std::int64_t>(), -42);
+  EXPECT_FALSE(section["int"].is<std::uint32_t>());
+  EXPECT_EQ(section["float"].as<double>(), 0.1);
+  EXPECT_TRUE(section["flag"].as<bool>());
+  EXPECT_EQ(section["big"].as<std::uint64_t>(), std::numeric_limits<std::uint64_t>::max());
+
+  // formatted like AsImpl::set, shortest text that parses back
+  EXPECT_EQ(section["float"].as<std::string>(), "0.1");
+  EXPECT_EQ(section["flag"].as<std::string_view>(), "true");
+  const auto text = parser.Stringify();
+  for (const auto* line : {"\nint=-42\n", "\nfloat=0.1\n", "\nflag=true\n", "\nbig=18446744073709551615\n"}) {
+    EXPECT_NE(text.find(line), std::string::npos) << line;
+  }
+  EXPECT_EQ(parser.StringifiedSize(), parser.Stringify().size());
+
+  ini::Parser::IniValue copy = section["float"];
+  section["float"] = 2.5f;
+  EXPECT_EQ(section["float"].as<float>(), 2.5f);
+  EXPECT_EQ(section["float"].as<std::string_view>(), "2.5");
+  EXPECT_EQ(copy.as<std::string_view>(), "0.1");
+  section["float"] = "text";
+  EXPECT_EQ(section["float"].as<std::string_view>(), "text");
+  EXPECT_FALSE(section["float"].is<float>());
+
+  // many readers asking for the text of the same native value at once
+  section.Add("shared", 123456789);
+  parser.Publish();
+  const auto snapshot = parser.GetSnapshot();
+  std::vector<std::thread> readers;
+  std::atomic<int> matches{0};
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&snapshot, &matches] {
+      matches += snapshot["native"]["shared"].as<std::string_view>() == "123456789";
+    });
+  }
+  for (auto& reader : readers) reader.join();
+  EXPECT_EQ(matches, 4);
+}
+
+TEST(Conversion, Numbers) {
+  using ini::conversion::AsImpl;
+
+  std::int64_t i64{};
+  EXPECT_TRUE(AsImpl<std::int64_t>::is("-9223372036854775808"));
+  AsImpl<std::int64_t>::get("-9223372036854775808", i64);
+  EXPECT_EQ(i64, std::numeric_limits<std::int64_t>::min());
+  EXPECT_FALSE(AsImpl<std::int64_t>::is("9223372036854775808"));
+  EXPECT_TRUE(AsImpl<std::uint64_t>::is("18446744073709551615"));
+  EXPECT_FALSE(AsImpl<std::uint64_t>::is("-1"));
+
+  std::int32_t i32{};
+  AsImpl<std::int32_t>::get("0x12ae", i32);
+  EXPECT_EQ(i32, 4782);
+  AsImpl<std::int32_t>::get("-0x10", i32);
+  EXPECT_EQ(i32, -16);
+  AsImpl<std::int32_t>::get("0o17", i32);
+  EXPECT_EQ(i32, 15);
+  AsImpl<std::int32_t>::get("0b101", i32);
+  EXPECT_EQ(i32, 5);
+  AsImpl<std::int32_t>::get("+017", i32);
+  EXPECT_EQ(i32, 17);
+
+  EXPECT_TRUE(AsImpl<std::int8_t>::is("-128"));
+  EXPECT_FALSE(AsImpl<std::int8_t>::is("128"));
+  EXPECT_FALSE(AsImpl<std::uint8_t>::is("0x100"));
+  EXPECT_FALSE(AsImpl<std::int32_t>::is("12abc"));
+  EXPECT_FALSE(AsImpl<std::int32_t>::is("3.14"));
+  EXPECT_FALSE(AsImpl<std::int32_t>::is("--1"));
+  EXPECT_FALSE(AsImpl<std::int32_t>::is("0x"));
+  EXPECT_FALSE(AsImpl<std::int32_t>::is(""));
+
+  double d{};
+  EXPECT_TRUE(AsImpl<double>::is("-1.5e3"));
+  AsImpl<double>::get("-1.5e3", d);
+  EXPECT_EQ(d, -1500.0);
+  EXPECT_FALSE(AsImpl<float>::is("1e39"));
+  EXPECT_FALSE(AsImpl<double>::is("inf"));
+  EXPECT_FALSE(AsImpl<double>::is("nan"));
+  EXPECT_FALSE(AsImpl<double>::is("1.5x"));
+
+  std::string out;
+  AsImpl<double>::set(0.1, out);
+  EXPECT_EQ(out, "0.1");
+  AsImpl<std::int8_t>::set(-5, out);
+  EXPECT_EQ(out, "-5");
+}
+
+TEST(Conversion, Hex) {
+  using ini::conversion::utility::HexToInt64;
+  using ini::conversion::utility::HexToUInt64;
+
+  EXPECT_EQ(HexToInt64("1A"), 0x1A);
+  EXPECT_EQ(HexToInt64("0x1a"), 0x1A);
+  EXPECT_EQ(HexToInt64("-0x1A"), -0x1A);
+  EXPECT_EQ(HexToInt64("-8000000000000000"), std::numeric_limits<std::int64_t>::min());
+  EXPECT_EQ(HexToUInt64("FFFFFFFFFFFFFFFF"), std::numeric_limits<std::uint64_t>::max());
+  EXPECT_EQ(HexToUInt64("0"), 0);
+  EXPECT_THROW(static_cast<void>(HexToInt64("8000000000000000")), std::out_of_range);
+  EXPECT_THROW(static_cast<void>(HexToUInt64("10000000000000000")), std::out_of_range);
+  EXPECT_THROW(static_cast<void>(HexToUInt64("-1")), std::out_of_range);
+  EXPECT_THROW(static_cast<void>(HexToInt64("xyz")), std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(HexToInt64("")), std::invalid_argument);
+}
+
 TEST(Conversion, UTF8) {
   std::string hello_world{ u8"hello, 世界" };
 
@@ -169,6 +659,748 @@ TEST(Conversion, UTF8) {
   #endif
 }
 
+TEST(Document, Map) {
+  ini::Document document(std::filesystem::path("test.ini"));
+  EXPECT_EQ(document.GetRootSection()["default section value"].as<std::string_view>(), "test value");
+  EXPECT_EQ(document["comment_val"]["val1"].as<std::string_view>(), "##hello");
+  EXPECT_EQ(document["Section 1"]["test_line_break"].as<std::string>(), "test1");
+  EXPECT_EQ(document["Section 1"]["option 3"].as<std::string_view>(), "value 3 = not value 2 = not value 1\\");
+  EXPECT_EQ(document["Numbers"]["num"].as<std::int32_t>(), -1285);
+  EXPECT_EQ(document["Numbers"]["float1"].as<double>(), -124.45667356);
+  EXPECT_TRUE(document["Other"]["bool2"].as<bool>());
+  EXPECT_EQ(document.GetSectionCount(), 4);
+  EXPECT_TRUE(document.SectionHasValue("Numbers", "num_hex"));
+  EXPECT_FALSE(document.SectionHasValue("Numbers", "missing"));
+  EXPECT_THROW(static_cast<void>(document["missing"]), std::runtime_error);
+}
+
+TEST(Document, Buffer) {
+  ini::Document document(std::string("a = 1\n"
+                                     "[dup]\n"
+                                     "old = 1\n"
+                                     "[other]\n"
+                                     "key = 1\n"
+                                     "key = 2\n"
+                                     "[dup]\n"
+                                     "new = 2\n"));
+  ini::Document moved(std::move(document));
+
+  EXPECT_EQ(moved.GetRootSection()["a"].as<int>(), 1);
+  EXPECT_FALSE(moved["dup"].HasValue("old"));
+  EXPECT_EQ(moved["dup"]["new"].as<int>(), 2);
+  EXPECT_EQ(moved["other"].Size(), 1);
+  EXPECT_EQ(moved["other"]["key"].as<int>(), 2);
+
+  std::size_t count = 0;
+  for (const auto& section : moved) {
+    count += section.second.Size();
+  }
+  EXPECT_EQ(count, 2);
+}
+
+TEST(Snapshot, Publish) {
+  ini::Parser parser;
+  EXPECT_EQ(parser.GetSnapshot().GetSectionCount(), 0);
+
+  parser.Parse("a = 1\n[section]\nb = 1\n", false);
+  parser.Publish();
+  const auto snapshot = parser.GetSnapshot();
+
+  parser.GetRootSection()["a"] = 2;
+  parser.RemoveSection("section");
+  EXPECT_EQ(snapshot.GetRootSection()["a"].as<int>(), 1);
+  EXPECT_TRUE(snapshot.SectionHasValue("section", "b"));
+  EXPECT_EQ(snapshot["section"]["b"].as<int>(), 1);
+
+  parser.Publish();
+  EXPECT_EQ(parser.GetSnapshot().GetRootSection()["a"].as<int>(), 2);
+  EXPECT_FALSE(parser.GetSnapshot().HasSection("section"));
+  EXPECT_EQ(snapshot.GetRootSection()["a"].as<int>(), 1);
+
+  // readers never see a half written document while the writer keeps publishing
+  std::atomic<bool> done{false};
+  std::atomic<std::size_t> torn{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&] {
+      while (!done.load()) {
+        const auto current = parser.GetSnapshot();
+        if (current.GetSectionCount() == 1 && current["s"]["x"].as<int>() != current["s"]["y"].as<int>()) {
+          torn++;
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < 200; i++) {
+    parser.Parse("[s]\nx = " + std::to_string(i) + "\ny = " + std::to_string(i) + "\n", false);
+    parser.Publish();
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(torn, 0);
+  EXPECT_EQ(parser.GetSnapshot()["s"]["x"].as<int>(), 199);
+}
+
+TEST(Schema, Bind) {
+  struct Config {
+    std::string name;
+    std::uint16_t port = 0;
+    std::string host;
+    bool verbose = false;
+    double ratio = 0;
+    int retries = 3;
+    int timeout = 0;
+    int missing = 0;
+  };
+
+  constexpr auto schema = ini::MakeSchema(
+      ini::MakeField("", "name", &Config::name),
+      ini::MakeField("Net", "port", &Config::port),
+      ini::MakeField("Net", "host", &Config::host),
+      ini::MakeField("Net", "retries", &Config::retries, false),
+      ini::MakeField("Net", "timeout", &Config::timeout),
+      ini::MakeField("Log", "verbose", &Config::verbose),
+      ini::MakeField("Log", "ratio", &Config::ratio),
+      ini::MakeField("Log", "missing", &Config::missing));
+
+  Config config;
+  const auto errors = schema.Bind("name = app\n"
+                                  "[Net]\n"
+                                  "port = 1\n"
+                                  "[Log]\n"
+                                  "verbose = on\n"
+                                  "ratio = 0.5\n"
+                                  "ratio = 0.25\n"
+                                  "[Net] ; replaces the first one\n"
+                                  "port = 8080\n"
+                                  "host = \"localhost\"\n"
+                                  "timeout = soon\n", config);
+
+  EXPECT_EQ(config.name, "app");
+  EXPECT_EQ(config.port, 8080);
+  EXPECT_EQ(config.host, "localhost");
+  EXPECT_EQ(config.retries, 3);
+  EXPECT_TRUE(config.verbose);
+  EXPECT_EQ(config.ratio, 0.25);
+
+  ASSERT_EQ(errors.size(), 2);
+  EXPECT_EQ(errors[0].type, ini::SchemaError::Type::Invalid);
+  EXPECT_EQ(errors[0].key, "timeout");
+  EXPECT_EQ(errors[0].value, "soon");
+  EXPECT_EQ(errors[1].type, ini::SchemaError::Type::Missing);
+  EXPECT_EQ(errors[1].section, "Log");
+  EXPECT_EQ(errors[1].key, "missing");
+
+  // a port that doesn't fit in 16 bits is invalid instead of truncated
+  Config overflow;
+  const auto overflow_errors = schema.Bind("[Net]\nport = 70000\n", overflow);
+  EXPECT_EQ(overflow.port, 0);
+  EXPECT_EQ(overflow_errors.front().type, ini::SchemaError::Type::Missing);
+  EXPECT_TRUE(std::any_of(overflow_errors.begin(), overflow_errors.end(), [](const ini::SchemaError& error) {
+    return error.type == ini::SchemaError::Type::Invalid && error.key == "port";
+  }));
+
+  Config from_file;
+  EXPECT_EQ(ini::MakeSchema(ini::MakeField("Numbers", "num", &Config::timeout)).Bind(std::filesystem::path("test.ini"), from_file).size(), 0);
+  EXPECT_EQ(from_file.timeout, -1285);
+}
+
+TEST(Editor, RoundTrip) {
+  const std::string contents = "; leading comment\r\n"
+                               "root = 1\r\n"
+                               "\r\n"
+                               "[a]   ; header comment\r\n"
+                               "x    =    \"quoted\"\r\n"
+                               "dup = old\r\n"
+                               "dup = new ; last one wins\r\n"
+                               "[b]\r\n"
+                               "z = 3";
+
+  ini::Editor unchanged{std::string(contents)};
+  EXPECT_FALSE(unchanged.IsDirty());
+  EXPECT_EQ(unchanged.Stringify(), contents);
+  EXPECT_EQ(unchanged.Get("a", "dup"), "new");
+  EXPECT_EQ(unchanged.Get<int>("", "root"), 1);
+
+  ini::Editor editor{std::string(contents)};
+  editor.Set("a", "x", "changed");
+  EXPECT_TRUE(editor.IsDirty());
+  EXPECT_EQ(editor.Stringify(), "; leading comment\r\n"
+                                "root = 1\r\n"
+                                "\r\n"
+                                "[a]   ; header comment\r\n"
+                                "x    =    \"changed\"\r\n"
+                                "dup = old\r\n"
+                                "dup = new ; last one wins\r\n"
+                                "[b]\r\n"
+                                "z = 3");
+
+  editor.Set("a", "added", 42);
+  editor.Set("b", "w", true);
+  editor.Set("c", "k", "v");
+  EXPECT_TRUE(editor.Remove("a", "dup"));
+  EXPECT_FALSE(editor.Remove("a", "dup"));
+  EXPECT_EQ(editor.Stringify(), "; leading comment\r\n"
+                                "root = 1\r\n"
+                                "\r\n"
+                                "[a]   ; header comment\r\n"
+                                "x    =    \"changed\"\r\n"
+                                "added=42\r\n"
+                                "[b]\r\n"
+                                "z = 3\r\n"
+                                "w=true\r\n"
+                                "[c]\r\n"
+                                "k=v\r\n");
+
+  EXPECT_TRUE(editor.RemoveSection("b"));
+  EXPECT_FALSE(editor.HasSection("b"));
+
+  // the result has to read back the same with the parser
+  ini::Parser parser;
+  parser.Parse(editor.Stringify(), false);
+  EXPECT_EQ(parser.GetSectionCount(), 2);
+  EXPECT_EQ(parser.GetRootSection()["root"].as<int>(), 1);
+  EXPECT_EQ(parser["a"]["x"].as<std::string>(), editor.Get<std::string>("a", "x"));
+  EXPECT_EQ(parser["a"]["added"].as<int>(), 42);
+  EXPECT_FALSE(parser["a"].HasValue("dup"));
+  EXPECT_EQ(parser["c"]["k"].as<std::string>(), "v");
+
+  EXPECT_TRUE(editor.Save("editor.ini"));
+  ini::Editor saved(std::filesystem::path("editor.ini"));
+  EXPECT_EQ(saved.Stringify(), editor.Stringify());
+  std::filesystem::remove("editor.ini");
+}
+
+TEST(Watcher, Reload) {
+  const auto write = [](const char* contents) {
+    std::ofstream("watched.ini", std::ios::trunc) << contents;
+  };
+  write("key = 1\n");
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<int> seen;
+  ini::Watcher watcher("watched.ini", [&](const std::shared_ptr<const ini::Parser>& parser) {
+    std::lock_guard lock(mutex);
+    seen.push_back(parser->GetRootSection()["key"].as<int>());
+    cv.notify_all();
+  }, std::chrono::milliseconds(20));
+
+  const auto wait_for = [&](const int value) {
+    std::unique_lock lock(mutex);
+    return cv.wait_for(lock, std::chrono::seconds(5), [&] { return !seen.empty() && seen.back() == value; });
+  };
+
+  // the first parse happens in the constructor
+  ASSERT_TRUE(wait_for(1));
+  const auto first = watcher.Current();
+  EXPECT_EQ(first->GetRootSection()["key"].as<int>(), 1);
+
+  // a burst of writes ends with the last contents
+  write("key = 2\n");
+  write("key = 3\n");
+  ASSERT_TRUE(wait_for(3));
+  EXPECT_EQ(watcher.Current()->GetRootSection()["key"].as<int>(), 3);
+  EXPECT_EQ(first->GetRootSection()["key"].as<int>(), 1);
+
+  // the same contents again are not published again
+  write("key = 3\n");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  write("key = 4\n");
+  ASSERT_TRUE(wait_for(4));
+  EXPECT_EQ(watcher.Current()->GetRootSection()["key"].as<int>(), 4);
+  {
+    std::lock_guard lock(mutex);
+    EXPECT_EQ(std::adjacent_find(seen.begin(), seen.end()), seen.end());
+    EXPECT_EQ(watcher.Reloads(), seen.size());
+  }
+  EXPECT_TRUE(watcher.LastError().empty());
+
+  std::filesystem::remove("watched.ini");
+}
+
+TEST(Watcher, Errors) {
+  std::ofstream("watched_errors.ini", std::ios::trunc) << "key = 1\n";
+
+  // a throwing callback is reported instead of ending the watcher thread
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::string> errors;
+  std::vector<int> seen;
+  ini::Watcher watcher("watched_errors.ini", [&](const std::shared_ptr<const ini::Parser>& parser) {
+    const auto key = parser->GetRootSection()["key"].as<int>();
+    {
+      std::lock_guard lock(mutex);
+      seen.push_back(key);
+    }
+    cv.notify_all();
+    if (key == 2) {
+      throw std::runtime_error("rejected");
+    }
+  }, std::chrono::milliseconds(20), [&](const std::string& error) {
+    std::lock_guard lock(mutex);
+    errors.push_back(error);
+    cv.notify_all();
+  });
+
+  const auto wait_for = [&](const int value) {
+    std::unique_lock lock(mutex);
+    return cv.wait_for(lock, std::chrono::seconds(5), [&] { return !seen.empty() && seen.back() == value; });
+  };
+
+  std::ofstream("watched_errors.ini", std::ios::trunc) << "key = 2\n";
+  ASSERT_TRUE(wait_for(2));
+  {
+    std::unique_lock lock(mutex);
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return !errors.empty(); }));
+    EXPECT_EQ(errors.back(), "Callback failed: rejected");
+  }
+  EXPECT_EQ(watcher.LastError(), "Callback failed: rejected");
+  EXPECT_EQ(watcher.Current()->GetRootSection()["key"].as<int>(), 2);
+
+  std::ofstream("watched_errors.ini", std::ios::trunc) << "key = 3\n";
+  ASSERT_TRUE(wait_for(3));
+  EXPECT_TRUE(watcher.LastError().empty());
+
+  std::filesystem::remove("watched_errors.ini");
+}
+
+TEST(Stream, Events) {
+  struct Recorder : ini::StreamHandler {
+    std::vector<std::string> events;
+    std::size_t stop_after = std::numeric_limits<std::size_t>::max();
+
+    bool OnSection(std::string_view name) {
+      events.push_back("section:" + std::string(name));
+      return events.size() < stop_after;
+    }
+
+    bool OnKeyValue(std::string_view key, std::string_view value) {
+      events.push_back(std::string(key) + "=" + std::string(value));
+      return events.size() < stop_after;
+    }
+
+    bool OnComment(std::string_view comment) {
+      events.push_back("comment:" + std::string(comment));
+      return events.size() < stop_after;
+    }
+  };
+
+  const std::string contents = "root = 1\r\n"
+                               "; full line\n"
+                               "[Section 1] # trailing\n"
+                               "a long key = a long value ; trailing\n"
+                               "last=value";
+  const std::vector<std::string> expected = {"root=1", "comment:; full line", "section:Section 1", "comment:# trailing",
+                                             "a long key=a long value", "comment:; trailing", "last=value"};
+
+  Recorder buffer_recorder;
+  EXPECT_TRUE(ini::ParseBuffer(contents, buffer_recorder));
+  EXPECT_EQ(buffer_recorder.events, expected);
+
+  // a chunk smaller than a line exercises the carry over between reads
+  std::istringstream stream(contents);
+  Recorder stream_recorder;
+  EXPECT_TRUE(ini::ParseStream(stream, stream_recorder, 4));
+  EXPECT_EQ(stream_recorder.events, expected);
+
+  std::istringstream stopped_stream(contents);
+  Recorder stopped;
+  stopped.stop_after = 3;
+  EXPECT_FALSE(ini::ParseStream(stopped_stream, stopped, 8));
+  EXPECT_EQ(stopped.events.size(), 3);
+}
+
+TEST(FlatMap, MatchesUnorderedMap) {
+  ini::FlatMap<std::string, int> flat;
+  std::unordered_map<std::string, int> reference;
+
+  std::uint32_t state = 12345;
+  const auto next = [&state] {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  };
+
+  for (int i = 0; i < 20000; i++) {
+    const std::string key = "key" + std::to_string(next() % 512);
+    switch (next() % 3) {
+      case 0:
+        flat.try_emplace(std::string(key), i);
+        reference.try_emplace(key, i);
+        break;
+      case 1:
+        EXPECT_EQ(flat.erase(key), reference.erase(key));
+        break;
+      default: {
+        const auto entry = flat.find(key);
+        const auto expected = reference.find(key);
+        ASSERT_EQ(entry == flat.end(), expected == reference.end());
+        if (entry != flat.end()) {
+          EXPECT_EQ(entry->second, expected->second);
+        }
+      }
+    }
+    ASSERT_EQ(flat.size(), reference.size());
+  }
+
+  std::size_t visited = 0;
+  for (const auto& [key, value] : flat) {
+    EXPECT_EQ(reference.at(key), value);
+    visited++;
+  }
+  EXPECT_EQ(visited, reference.size());
+}
+
+TEST(Parse, Parallel) {
+  const auto equal = [](const ini::Parser::IniSection& a, ini::Parser::IniSection& b) {
+    if (a.Size() != b.Size()) return false;
+    for (auto it = a.cbegin(); it != a.cend(); ++it) {
+      if (!b.HasValue(it->first) || b[it->first].as<std::string_view>() != it->second.as<std::string_view>()) return false;
+    }
+    return true;
+  };
+  const auto same = [&equal](ini::Parser& a, ini::Parser& b) {
+    if (a.GetSectionCount() != b.GetSectionCount() || !equal(a.GetRootSection(), b.GetRootSection())) return false;
+    for (auto it = a.cbegin(); it != a.cend(); ++it) {
+      if (!b.HasSection(it->first) || !equal(it->second, b[it->first])) return false;
+    }
+    return true;
+  };
+
+  // large enough to be split, with repeated sections and keys crossing the split points
+  std::string contents = "root = 1\r\nroot = 2\n[not a section\n";
+  for (int i = 0; i < 20000; i++) {
+    contents += "[section " + std::to_string(i % 700) + "]\n";
+    contents += "key = " + std::to_string(i) + "\r\n";
+    contents += "key" + std::to_string(i % 3) + " = value ; comment\n";
+    contents += "[x=y\n";
+  }
+  const std::string tail = "tail = 1\n";
+
+  for (const unsigned threads : {1u, 2u, 3u, 8u}) {
+    ini::Parser sequential(false);
+    sequential.Parse(contents, false);
+    sequential.Parse(tail, false);
+
+    ini::Parser parallel(false);
+    parallel.ParseParallel(contents, false, threads);
+    parallel.ParseParallel(tail, false, threads);
+    EXPECT_TRUE(same(sequential, parallel)) << threads << " threads";
+    EXPECT_EQ(parallel["section 399"]["tail"].as<int>(), 1);
+  }
+
+  ini::Parser from_file;
+  ini::Parser expected;
+  from_file.ParseParallel(std::filesystem::path("test.ini"), 4);
+  expected.Parse(std::filesystem::path("test.ini"));
+  EXPECT_TRUE(same(expected, from_file));
+}
+
+TEST(Loader, Directory) {
+  const auto directory = std::filesystem::temp_directory_path() / "inireader_loader_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory / "sub.ini");
+  for (int i = 0; i < 20; i++) {
+    std::ofstream(directory / ("fragment " + std::to_string(i) + ".ini"), std::ios::binary) << "[fragment]\nid = " << i << "\n";
+  }
+  std::ofstream(directory / "notes.txt") << "not = loaded\n";
+
+  // sorted by path, the sub directory and other extensions are skipped
+  const auto loaded = ini::LoadDirectory(directory, ".ini", 4);
+  ASSERT_EQ(loaded.size(), 20);
+  EXPECT_TRUE(std::is_sorted(loaded.begin(), loaded.end(), [](const ini::LoadedFile& lhs, const ini::LoadedFile& rhs) {
+    return lhs.path < rhs.path;
+  }));
+  for (const auto& file : loaded) {
+    ASSERT_TRUE(file.parser) << file.error;
+    EXPECT_EQ(file.path.filename().string(), "fragment " + std::to_string((*file.parser)["fragment"]["id"].as<int>()) + ".ini");
+  }
+
+  // errors are reported per file in the order of the paths
+  const auto files = ini::LoadFiles({directory / "fragment 3.ini", directory / "missing.ini", directory / "sub.ini", directory / "notes.txt"});
+  ASSERT_EQ(files.size(), 4);
+  EXPECT_EQ((*files[0].parser)["fragment"]["id"].as<int>(), 3);
+  EXPECT_FALSE(files[1].parser);
+  EXPECT_EQ(files[1].error, "File not found");
+  EXPECT_EQ(files[2].error, "Not a regular file");
+  EXPECT_EQ(files[3].parser->GetRootSection()["not"].as<std::string>(), "loaded");
+  EXPECT_TRUE(ini::LoadFiles({}).empty());
+  EXPECT_ANY_THROW(ini::LoadDirectory(directory / "missing"));
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(Overlay, Layers) {
+  const auto layer = [](const std::string& contents) {
+    auto parser = std::make_shared<ini::Parser>();
+    parser->Parse(contents, false);
+    return std::shared_ptr<const ini::Parser>(std::move(parser));
+  };
+
+  for (const bool memoize : {false, true}) {
+    ini::Overlay overlay({layer("level = defaults\n[net]\nport = 80\nhost = localhost\n[log]\nlevel = info\n"),
+                          layer("[net]\nhost = region.example\n[region]\nname = eu\n"),
+                          layer("[net]\nport = 8080\n")}, memoize);
+
+    // a key comes from the highest layer that has it, the other keys of the section fall through
+    EXPECT_EQ(overlay["net"]["port"].as<int>(), 8080);
+    EXPECT_EQ(overlay["net"]["host"].as<std::string>(), "region.example");
+    EXPECT_EQ(overlay["log"]["level"].as<std::string>(), "info");
+    EXPECT_EQ(overlay.GetRootSection()["level"].as<std::string>(), "defaults");
+    EXPECT_TRUE(overlay.HasSection("region"));
+    EXPECT_FALSE(overlay.HasSection("missing"));
+    EXPECT_TRUE(overlay.SectionHasValue("net", "host"));
+    EXPECT_FALSE(overlay.SectionHasValue("net", "missing"));
+    EXPECT_FALSE(overlay.SectionHasValue("missing", "port"));
+    EXPECT_ANY_THROW(static_cast<void>(overlay["missing"]));
+    EXPECT_ANY_THROW(static_cast<void>(overlay["net"]["missing"]));
+
+    // the value is the one of the layer, nothing is copied
+    EXPECT_EQ(&overlay["net"]["host"], &(*overlay.GetLayer(1))["net"]["host"]);
+
+    // every section and key once
+    std::vector<std::string> sections;
+    for (const auto section : overlay) {
+      sections.emplace_back(section.Name());
+    }
+    std::sort(sections.begin(), sections.end());
+    EXPECT_EQ(sections, (std::vector<std::string>{"log", "net", "region"}));
+    EXPECT_EQ(overlay.GetSectionCount(), 3);
+
+    std::vector<std::pair<std::string, std::string>> items;
+    for (const auto item : overlay["net"]) {
+      items.emplace_back(item.key, item.value.as<std::string>());
+    }
+    std::sort(items.begin(), items.end());
+    EXPECT_EQ(items, (std::vector<std::pair<std::string, std::string>>{{"host", "region.example"}, {"port", "8080"}}));
+
+    // a reload replaces one layer, keys of the layers above it still resolve the same
+    overlay.SetLayer(1, layer("[net]\nhost = other.example\nport = 1\n"));
+    EXPECT_EQ(overlay["net"]["host"].as<std::string>(), "other.example");
+    EXPECT_EQ(overlay["net"]["port"].as<int>(), 8080);
+    EXPECT_FALSE(overlay.HasSection("region"));
+
+    overlay.AddLayer(layer("[net]\nmissing = 1\n"));
+    EXPECT_TRUE(overlay.SectionHasValue("net", "missing"));
+    EXPECT_EQ(overlay.GetLayerCount(), 4);
+    EXPECT_ANY_THROW(overlay.SetLayer(4, layer("")));
+  }
+}
+
+TEST(Compiled, Load) {
+  const auto dir = std::filesystem::temp_directory_path();
+  const auto source = dir / "test_inireader_compiled.ini";
+  const auto image = dir / "test_inireader_compiled.inic";
+  std::filesystem::remove(image);
+
+  ini::Parser expected;
+  expected.Parse(std::filesystem::path("test.ini"));
+  std::filesystem::copy_file("test.ini", source, std::filesystem::copy_options::overwrite_existing);
+
+  const auto same = [&expected](const ini::CompiledDocument& document) {
+    const auto equal = [](const ini::Parser::IniSection& a, const ini::CompiledDocument::Section& b) {
+      std::size_t visited = 0;
+      for (const auto& [key, value] : b) {
+        if (!a.HasValue(key) || a[key].as<std::string_view>() != value.as<std::string_view>()) return false;
+        visited++;
+      }
+      return visited == a.Size() && b.Size() == a.Size();
+    };
+
+    if (document.GetSectionCount() != expected.GetSectionCount() || !equal(expected.GetRootSection(), document.GetRootSection())) return false;
+    for (const auto& [name, section] : document) {
+      if (!expected.HasSection(name) || !equal(expected[name], section)) return false;
+    }
+    return true;
+  };
+
+  // no image yet, parses the source and writes one
+  EXPECT_FALSE(ini::CompiledDocument::Open(image, source).has_value());
+  const auto parsed = ini::CompiledDocument::Load(source, image);
+  EXPECT_TRUE(same(parsed));
+  ASSERT_TRUE(std::filesystem::exists(image));
+
+  const auto opened = ini::CompiledDocument::Open(image, source, true);
+  ASSERT_TRUE(opened.has_value());
+  EXPECT_TRUE(same(*opened));
+  EXPECT_EQ((*opened)["Numbers"]["num"].as<int>(), -1285);
+  EXPECT_TRUE(opened->SectionHasValue("Section 1", "Option 1"));
+  EXPECT_FALSE(opened->SectionHasValue("Section 1", "missing"));
+  EXPECT_FALSE(opened->HasSection(""));
+  EXPECT_FALSE(opened->HasSection("missing"));
+  EXPECT_TRUE(opened->GetRootSection().HasValue("default section value"));
+
+  // same size and contents with a new modification time is still current
+  std::filesystem::last_write_time(source, std::filesystem::last_write_time(source) + std::chrono::hours(1));
+  EXPECT_TRUE(ini::CompiledDocument::Open(image, source).has_value());
+
+  // a changed source makes the image stale and Load rewrites it
+  {
+    std::ofstream ofs(source, std::ios::app);
+    ofs << "\n[appended]\nkey = 1\n";
+  }
+  EXPECT_FALSE(ini::CompiledDocument::Open(image, source).has_value());
+  const auto reloaded = ini::CompiledDocument::Load(source, image);
+  EXPECT_EQ(reloaded["appended"]["key"].as<int>(), 1);
+  EXPECT_TRUE(ini::CompiledDocument::Open(image, source).has_value());
+
+  // anything that isn't a complete image is rejected
+  std::string truncated;
+  {
+    std::ifstream ifs(image, std::ios::binary);
+    truncated.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  }
+  truncated.pop_back();
+  EXPECT_THROW(ini::CompiledDocument(std::string(truncated)), std::runtime_error);
+  EXPECT_THROW(ini::CompiledDocument(std::string("INIC")), std::runtime_error);
+  {
+    std::ofstream ofs(image, std::ios::binary | std::ios::trunc);
+    ofs << truncated;
+  }
+  EXPECT_FALSE(ini::CompiledDocument::Open(image, source).has_value());
+
+  ASSERT_TRUE(ini::Compile(expected, "test.ini", image));
+  EXPECT_TRUE(same(ini::CompiledDocument(image)));
+
+  // bucket tables without an empty bucket throw on a miss instead of probing forever
+  {
+    std::string full;
+    {
+      std::ifstream ifs(image, std::ios::binary);
+      full.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    ini::utility::compiled::Header header{};
+    std::memcpy(&header, full.data(), sizeof(header));
+    const std::uint32_t one = 1;
+    for (std::uint32_t i = 0; i < header.section_bucket_count; i++) {
+      std::memcpy(full.data() + header.section_buckets_offset + i * sizeof(one), &one, sizeof(one));
+    }
+    for (std::uint32_t i = 0; i < header.entry_bucket_count; i++) {
+      std::memcpy(full.data() + header.entry_buckets_offset + i * sizeof(one), &one, sizeof(one));
+    }
+
+    const ini::CompiledDocument corrupt{std::move(full)};
+    EXPECT_THROW(static_cast<void>(corrupt.HasSection("missing")), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(corrupt.GetRootSection().HasValue("missing")), std::runtime_error);
+  }
+
+  std::filesystem::remove(source);
+  std::filesystem::remove(image);
+}
+
+TEST(Get, Many) {
+  ini::Parser parser;
+  parser.Parse("[tunables]\nthreads = 8\nverbose = yes\nratio = 0.75\nname = \"worker\"\nport = 99999\n", false);
+  const auto& section = parser["tunables"];
+
+  const auto [threads, verbose, ratio, name] = section.GetMany<int, bool, double, std::string>("threads", "verbose", "ratio", "name");
+  EXPECT_EQ(threads, 8);
+  EXPECT_EQ(verbose, true);
+  EXPECT_EQ(ratio, 0.75);
+  EXPECT_EQ(name, "worker");
+
+  // every problem is reported, not just the first one
+  std::vector<ini::LookupError> errors;
+  const std::string missing = "missing";
+  const auto [port, nothing, also_threads] = section.GetMany<std::uint16_t, int, std::int64_t>(errors, "port", missing, std::string_view("threads"));
+  EXPECT_FALSE(port.has_value());
+  EXPECT_FALSE(nothing.has_value());
+  EXPECT_EQ(also_threads, 8);
+  ASSERT_EQ(errors.size(), 2);
+  EXPECT_EQ(errors[0].type, ini::LookupError::Type::Invalid);
+  EXPECT_EQ(errors[0].index, 0);
+  EXPECT_EQ(errors[0].key, "port");
+  EXPECT_EQ(errors[1].type, ini::LookupError::Type::Missing);
+  EXPECT_EQ(errors[1].index, 1);
+  EXPECT_EQ(errors[1].key, "missing");
+
+  EXPECT_EQ(std::get<0>(ini::Parser::IniSection().GetMany<int>("a")), std::nullopt);
+
+  int value = 0;
+  EXPECT_TRUE(section["threads"].TryAs(value));
+  EXPECT_EQ(value, 8);
+  EXPECT_FALSE(section["name"].TryAs(value));
+  EXPECT_EQ(value, 8);
+}
+
+TEST(Frozen, Lookup) {
+  const auto same = [](const ini::Parser& parser, const ini::FrozenDocument& frozen) {
+    const auto equal = [](const ini::Parser::IniSection& a, const ini::FrozenDocument::Section& b) {
+      if (a.Size() != b.Size()) return false;
+      for (const auto& [key, value] : a) {
+        if (!b.HasValue(key) || b[key].as<std::string_view>() != value.as<std::string_view>()) return false;
+      }
+      return !b.HasValue("missing") && !b.HasValue("");
+    };
+
+    if (frozen.GetSectionCount() != parser.GetSectionCount() || !equal(parser.GetRootSection(), frozen.GetRootSection())) return false;
+    for (auto it = parser.cbegin(); it != parser.cend(); ++it) {
+      if (!frozen.HasSection(it->first) || !equal(it->second, frozen[it->first])) return false;
+    }
+    return std::all_of(frozen.begin(), frozen.end(), [&parser](const ini::FrozenDocument::SectionEntry& entry) {
+      return parser.HasSection(entry.first);
+    });
+  };
+
+  EXPECT_TRUE(same(g_testctx->ini_file, ini::FrozenDocument(g_testctx->ini_file)));
+
+  std::string contents;
+  for (int s = 0; s < 3000; s++) {
+    contents += "[section " + std::to_string(s) + "]\n";
+    for (int k = 0; k < s % 40; k++) {
+      contents += "key" + std::to_string(k * 7919) + " = " + std::to_string(s * k) + "\n";
+    }
+  }
+  ini::Parser parser;
+  parser.Parse(contents, false);
+  const ini::FrozenDocument frozen(parser);
+  EXPECT_TRUE(same(parser, frozen));
+  EXPECT_EQ(frozen["section 2999"]["key" + std::to_string(38 * 7919)].as<int>(), 2999 * 38);
+  EXPECT_FALSE(frozen.HasSection("section 3000"));
+  EXPECT_FALSE(frozen.SectionHasValue("section 0", "key0"));
+
+  const ini::FrozenDocument empty{ini::Parser()};
+  EXPECT_EQ(empty.GetSectionCount(), 0);
+  EXPECT_FALSE(empty.HasSection("section"));
+  EXPECT_FALSE(empty.GetRootSection().HasValue("key"));
+
+  // equal keys fail with every salt, distinct keys get every slot once
+  ini::utility::PerfectHash hash;
+  EXPECT_ANY_THROW(hash.Build({"same", "other", "same"}));
+  std::vector<std::string> names;
+  for (int i = 0; i < 1000; i++) {
+    names.push_back("name " + std::to_string(i));
+  }
+  const auto order = hash.Build(std::vector<std::string_view>(names.begin(), names.end()));
+  for (std::uint32_t slot = 0; slot < order.size(); slot++) {
+    EXPECT_EQ(hash.Slot(names[order[slot]]), slot);
+  }
+}
+
+TEST(File, Stringify) {
+  ini::Parser parser;
+  parser.Parse("root = 1\n[section]\nkey = \"a long value that does not fit in a small string\"\n", false);
+  EXPECT_EQ(parser.Stringify(), "root=1\n[section]\nkey=a long value that does not fit in a small string\n");
+  EXPECT_EQ(parser.StringifiedSize(), parser.Stringify().size());
+  EXPECT_EQ(parser["section"].Stringify(), "key=a long value that does not fit in a small string\n");
+
+  std::ostringstream stream;
+  parser.Write(stream);
+  EXPECT_EQ(stream.str(), parser.Stringify());
+
+  // a buffer smaller than the values has to pass them through unbuffered
+  std::ostringstream small;
+  ini::utility::BufferedWriter writer(small, 4);
+  parser["section"].Write(writer);
+  writer.Flush();
+  EXPECT_EQ(small.str(), parser["section"].Stringify());
+
+  EXPECT_EQ(g_testctx->ini_file.StringifiedSize(), g_testctx->ini_file.Stringify().size());
+}
+
 TEST(File, Save) {
     EXPECT_EQ(g_testctx->ini_file.Save("test2.ini"), true);
 }